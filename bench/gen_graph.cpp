@@ -0,0 +1,239 @@
+/**
+ * @file gen_graph.cpp
+ * @brief This program writes a synthetic random graph, in the input format
+ * of one of the converters, for benchmarking them at any size.
+ *
+ * Usage: gen_graph [-n <nodes>] [-d <density>] [-w <weights>]
+ *                  [-z <isolated>] [-f <format>] [-B] [-r <seed>] [-h]
+ *
+ * Every pair of the nodes that are not isolated is an edge with probability
+ * density, independently.  The edges are drawn by jumping from an edge to
+ * the next one with a geometric skip over the pairs, so that the running
+ * time is linear in the number of edges whatever the density; they are
+ * written in increasing order of (i, j), with i < j.  Since the number of
+ * edges is written first, the pairs are drawn twice from the same random
+ * stream.  The graph depends only on the options: the same seed gives the
+ * same graph.
+ *
+ * A fraction of the nodes can be isolated, as the missing qubits of a
+ * Chimera graph: they keep their indices but have no edges, so that
+ * deChimera has nodes to remove.
+ *
+ * Options:
+ *   -n <nodes>: number of nodes (default: 1000).
+ *   -d <density>: probability of an edge between two nodes that are not
+ *       isolated (default: 0.01).
+ *   -w <weights>: distribution of the weights (default: int):
+ *       unit: all weights are 1;
+ *       sign: -1 or 1 with the same probability;
+ *       int: integers in [-100, 100] but 0, uniformly;
+ *       uniform: reals in [-1, 1), uniformly;
+ *       gauss: reals with the standard normal distribution.
+ *   -z <isolated>: fraction of isolated nodes (default: 0).
+ *   -f <format>: format of the graph (default: mc):
+ *       mc: the edge list read by negate, scale_img, deChimera and Qubo2mc
+ *           (n m, then the lines i j w);
+ *       qplib: an instance read by qplib2mc, named "synthetic", with the
+ *           diagonal entries of one node out of ten;
+ *       net: the network read by netRep2mc (n n m, then the lines i j).
+ *   -B: with the format mc, the graph is written in the binary format of
+ *       edge_io.h.
+ *   -r <seed>: seed of the random numbers (default: 1).
+ *   -h: print the usage.
+ *
+ * Output Format:
+ *   The graph is written to standard output, with 1-based nodes.
+ */
+
+#include <unistd.h>  // For getopt
+
+#include <cmath>     // For log, floor
+#include <cstdint>   // For the fixed-size integers
+#include <cstdlib>   // For EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>   // For strcmp
+#include <iostream>  // For the error messages
+#include <random>    // For the random numbers
+#include <string>    // For the options
+#include <vector>    // For the nodes that are not isolated
+
+#include "edge_io.h"  // For writing the graphs
+
+using namespace std;
+
+// The options of the graph.
+struct Options {
+  uint64_t n = 1000;
+  double density = 0.01;
+  string weights = "int";
+  double isolated = 0.0;
+  string format = "mc";
+  bool binary = false;
+  uint64_t seed = 1;
+};
+
+// Draws the edges of the graph among the nodes of active (1-based), in
+// increasing order, calling edge(i, j) for every one of them.
+template <class F>
+void draw_edges(const Options& o, const vector<uint64_t>& active, F edge) {
+  uint64_t N = active.size();
+  if (N < 2 || o.density <= 0) return;
+  mt19937_64 rng(o.seed);
+  uniform_real_distribution<double> U(0.0, 1.0);
+  double log_q = log1p(-min(o.density, 1.0));  // -inf for density 1
+  uint64_t pairs = N * (N - 1) / 2;
+  // pair k is (i, i + 1 + k - first), first being the first pair of row i
+  uint64_t i = 0, first = 0;
+  for (uint64_t k = 0;; ++k) {
+    if (o.density < 1.0) {
+      double skip = floor(log1p(-U(rng)) / log_q);
+      if (skip >= static_cast<double>(pairs - k)) return;
+      k += static_cast<uint64_t>(skip);
+    }
+    if (k >= pairs) return;
+    while (k - first >= N - 1 - i) {
+      first += N - 1 - i;
+      ++i;
+    }
+    edge(active[i], active[i + 1 + k - first]);
+  }
+}
+
+// Draws the weights of the given distribution.
+class Weights {
+ public:
+  Weights(const string& kind, uint64_t seed) : rng(seed ^ kWeightStream) {
+    if (kind == "unit")
+      type = kUnit;
+    else if (kind == "sign")
+      type = kSign;
+    else if (kind == "int")
+      type = kInt;
+    else if (kind == "uniform")
+      type = kUniform;
+    else if (kind == "gauss")
+      type = kGauss;
+    else
+      valid = false;
+  }
+  bool integral() const { return type == kUnit || type == kSign || type == kInt; }
+  double operator()() {
+    switch (type) {
+      case kUnit:
+        return 1;
+      case kSign:
+        return rng() & 1 ? 1 : -1;
+      case kInt: {
+        int w = uniform_int_distribution<int>(-100, 99)(rng);
+        return w >= 0 ? w + 1 : w;
+      }
+      case kUniform:
+        return uniform_real_distribution<double>(-1.0, 1.0)(rng);
+      case kGauss:
+        return normal_distribution<double>()(rng);
+    }
+    return 0;
+  }
+  bool valid = true;
+
+ private:
+  static constexpr uint64_t kWeightStream = 0x9e3779b97f4a7c15;
+  enum { kUnit, kSign, kInt, kUniform, kGauss } type = kUnit;
+  mt19937_64 rng;
+};
+
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-n <nodes>] [-d <density>] "
+       << "[-w <weights>] [-z <isolated>]" << endl
+       << string(strlen(program) + 8, ' ')
+       << "[-f <format>] [-B] [-r <seed>] [-h]" << endl;
+  cerr << " -n <nodes> [default: 1000]: number of nodes." << endl;
+  cerr << " -d <density> [default: 0.01]: probability of every edge." << endl;
+  cerr << " -w <weights> [default: int]: unit, sign, int (in [-100, 100]), "
+       << "uniform" << endl
+       << "    (in [-1, 1)) or gauss (standard normal)." << endl;
+  cerr << " -z <isolated> [default: 0]: fraction of isolated nodes." << endl;
+  cerr << " -f <format> [default: mc]: mc (n m and the edges i j w), qplib "
+       << "or net." << endl;
+  cerr << " -B flag: the mc graph is written in the binary format." << endl;
+  cerr << " -r <seed> [default: 1]: seed of the random numbers." << endl;
+  cerr << " -h flag: print this message." << endl;
+}
+
+int main(int argc, char** argv) {
+  Options o;
+  bool print_help = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:d:w:z:f:Br:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        o.n = strtoull(optarg, nullptr, 10);
+        break;
+      case 'd':
+        o.density = atof(optarg);
+        break;
+      case 'w':
+        o.weights = optarg;
+        break;
+      case 'z':
+        o.isolated = atof(optarg);
+        break;
+      case 'f':
+        o.format = optarg;
+        break;
+      case 'B':
+        o.binary = true;
+        break;
+      case 'r':
+        o.seed = strtoull(optarg, nullptr, 10);
+        break;
+      case 'h':
+      default:
+        print_help = true;
+    }
+  }
+  Weights weight(o.weights, o.seed);
+  if (print_help || optind != argc || !weight.valid || o.density < 0 ||
+      o.isolated < 0 || o.isolated > 1 ||
+      (o.format != "mc" && o.format != "qplib" && o.format != "net") ||
+      (o.binary && o.format != "mc")) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  // the nodes that are not isolated
+  vector<uint64_t> active;
+  {
+    mt19937_64 rng(o.seed + 1);
+    uniform_real_distribution<double> U(0.0, 1.0);
+    for (uint64_t v = 1; v <= o.n; ++v)
+      if (!(U(rng) < o.isolated)) active.push_back(v);
+  }
+  uint64_t m = 0;
+  draw_edges(o, active, [&m](uint64_t, uint64_t) { ++m; });
+
+  if (o.format == "mc") {
+    GraphOutput out(o.binary);
+    out.write_header(o.n, m, weight.integral() ? kWeightInt64 : kWeightDouble);
+    draw_edges(o, active, [&](uint64_t i, uint64_t j) {
+      out.write_edge(i, j, weight());
+    });
+  } else if (o.format == "qplib") {
+    EdgeWriter out;
+    out << "synthetic\n# objective type\n# variable type\n";
+    out << o.n << " # number of variables\n" << m << " # number of edges\n";
+    draw_edges(o, active, [&](uint64_t i, uint64_t j) {
+      out << i << ' ' << j << ' ' << weight() << '\n';
+    });
+    out << 0.0 << " # default diagonal value\n";
+    out << (o.n + 9) / 10 << " # number of diagonal entries\n";
+    for (uint64_t v = 1; v <= o.n; v += 10) out << v << ' ' << weight() << '\n';
+  } else {
+    EdgeWriter out;
+    out << o.n << ' ' << o.n << ' ' << m << '\n';
+    draw_edges(o, active, [&](uint64_t i, uint64_t j) {
+      out << i << ' ' << j << '\n';
+    });
+  }
+  return EXIT_SUCCESS;
+}
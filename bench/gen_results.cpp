@@ -0,0 +1,135 @@
+/**
+ * @file gen_results.cpp
+ * @brief This program writes a synthetic results file, in the format read
+ * by tablegenerator, for benchmarking it at any size.
+ *
+ * Usage: gen_results [-i <instances>] [-a <algorithms>] [-s <seeds>]
+ *                    [-l <history>] [-t <ties>] [-r <seed>] [-h]
+ *
+ * Every algorithm is run with every seed on every instance, in this order.
+ * The best value of an instance is drawn once; a run reaches it with
+ * probability ties (so that runs tie for FE, BA and the ranks), otherwise it
+ * ends below it.  The history of a run has between 1 and <history> entries,
+ * of increasing values and times, the last one being the objective and the
+ * time of the run, within its time limit.  The file depends only on the
+ * options: the same seed gives the same file.
+ *
+ * Options:
+ *   -i <instances>: number of instances (default: 100).
+ *   -a <algorithms>: number of algorithms (default: 10).
+ *   -s <seeds>: number of seeds (default: 5).
+ *   -l <history>: maximum number of entries of a history (default: 10).
+ *   -t <ties>: probability that a run reaches the best value of its
+ *       instance (default: 0.2).
+ *   -r <seed>: seed of the random numbers (default: 1).
+ *   -h: print the usage.
+ *
+ * Output Format:
+ *   The results file is written to standard output: a header line, then one
+ *   line per run,
+ *     timestamp,graphname,algorithm,seed,time_limit,objective,time,history
+ *   with algorithms named alg<k>, instances inst<k> and seeds <k>.
+ */
+
+#include <unistd.h>  // For getopt
+
+#include <algorithm>  // For sort
+#include <cstdint>    // For the fixed-size integers
+#include <cstdlib>    // For EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>    // For strlen
+#include <iostream>   // For the error messages
+#include <random>     // For the random numbers
+#include <string>     // For the options
+#include <vector>     // For the histories
+
+#include "edge_io.h"  // For the buffered output
+
+using namespace std;
+
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-i <instances>] [-a <algorithms>] "
+       << "[-s <seeds>]" << endl
+       << string(strlen(program) + 8, ' ')
+       << "[-l <history>] [-t <ties>] [-r <seed>] [-h]" << endl;
+  cerr << " -i <instances> [default: 100]: number of instances." << endl;
+  cerr << " -a <algorithms> [default: 10]: number of algorithms." << endl;
+  cerr << " -s <seeds> [default: 5]: number of seeds." << endl;
+  cerr << " -l <history> [default: 10]: maximum length of a history." << endl;
+  cerr << " -t <ties> [default: 0.2]: probability that a run reaches the "
+       << "best value." << endl;
+  cerr << " -r <seed> [default: 1]: seed of the random numbers." << endl;
+  cerr << " -h flag: print this message." << endl;
+}
+
+int main(int argc, char** argv) {
+  uint64_t n_instances = 100, n_algorithms = 10, n_seeds = 5;
+  uint64_t history = 10;
+  double ties = 0.2;
+  uint64_t seed = 1;
+  bool print_help = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "i:a:s:l:t:r:h")) != -1) {
+    switch (opt) {
+      case 'i':
+        n_instances = strtoull(optarg, nullptr, 10);
+        break;
+      case 'a':
+        n_algorithms = strtoull(optarg, nullptr, 10);
+        break;
+      case 's':
+        n_seeds = strtoull(optarg, nullptr, 10);
+        break;
+      case 'l':
+        history = strtoull(optarg, nullptr, 10);
+        break;
+      case 't':
+        ties = atof(optarg);
+        break;
+      case 'r':
+        seed = strtoull(optarg, nullptr, 10);
+        break;
+      case 'h':
+      default:
+        print_help = true;
+    }
+  }
+  if (print_help || optind != argc || history < 1 || ties < 0 || ties > 1) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  mt19937_64 rng(seed);
+  uniform_real_distribution<double> U(0.0, 1.0);
+  const double kLimits[] = {10, 60, 300};  // the time limits of the instances
+  EdgeWriter out;
+  out << "timestamp,graphname,algorithm,seed,timelimit,objective,time,"
+      << "history\n";
+  vector<int64_t> values;
+  vector<double> times;
+  for (uint64_t i = 0; i != n_instances; ++i) {
+    int64_t best = uniform_int_distribution<int64_t>(1000, 1000000)(rng);
+    double limit = kLimits[rng() % 3];
+    for (uint64_t a = 0; a != n_algorithms; ++a)
+      for (uint64_t s = 0; s != n_seeds; ++s) {
+        // the history, ending at the objective
+        size_t length = 1 + rng() % history;
+        int64_t objective =
+            U(rng) < ties ? best : best - 1 - static_cast<int64_t>(rng() % 100);
+        values.resize(length);
+        times.resize(length);
+        values[length - 1] = objective;
+        for (size_t k = length - 1; k-- > 0;)
+          values[k] = values[k + 1] - 1 - static_cast<int64_t>(rng() % 1000);
+        for (double& t : times)
+          t = 0.001 * (1 + rng() % static_cast<uint64_t>(1000 * limit));
+        sort(times.begin(), times.end());
+        out << "2024-01-01,inst" << i << ",alg" << a << ',' << s << ','
+            << limit << ',' << objective << ',' << times[length - 1] << ',';
+        for (size_t k = 0; k != length; ++k)
+          out << values[k] << ':' << times[k] << ';';
+        out << '\n';
+      }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#!/bin/bash
+#
+# Benchmarks tablegenerator and the converters on synthetic data.
+#
+# Usage: run_bench.sh <build_dir> [<size> ...]
+#
+# For every size s (default: 1 10) the script generates, with gen_results
+# and gen_graph of <build_dir>:
+#   - a results file of 100*s instances, 20 algorithms and 5 seeds, with
+#     histories of up to 10 entries and 20% of ties;
+#   - graphs of 10000*s nodes with about 10 edges per node.
+# It then times
+#   - tablegenerator reading the results file, from the text file and from
+#     its binary cache, and computing every statistic, as reported by its
+#     option -j;
+#   - every converter on a graph of its input format, then graphbatch
+#     converting these graphs at once.
+# Every measure is printed as one line
+#   <benchmark> <size> <items> <seconds> <items per second>
+# the items being the rows of the results file or the edges of the graphs.
+# The data are generated in a temporary directory, removed at the end
+# unless BENCH_KEEP is set; BENCH_TMPDIR sets the directory in which it is
+# created.
+
+set -e
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <build_dir> [<size> ...]" >&2
+  exit 1
+fi
+BIN=$(cd "$1" && pwd)
+shift
+SIZES=${*:-1 10}
+
+WORK=$(mktemp -d "${BENCH_TMPDIR:-/tmp}/bench.XXXXXX")
+if [ -z "$BENCH_KEEP" ]; then
+  trap 'rm -rf "$WORK"' EXIT
+else
+  echo "# data kept in $WORK"
+fi
+cd "$WORK"
+
+# Prints the nanoseconds since the epoch.
+now() { date +%s%N; }
+
+# Prints a measure: report <benchmark> <size> <items> <nanoseconds>.
+report() {
+  awk -v b="$1" -v s="$2" -v n="$3" -v t="$4" 'BEGIN {
+    sec = t / 1e9;
+    printf "%-48s %6s %12d %10.4f %14.0f\n", b, s, n, sec,
+           (sec > 0 ? n / sec : 0)
+  }'
+}
+
+# Runs a command with its standard input and output redirected, and prints
+# its measure: timed <benchmark> <size> <items> <input> <output> <command>.
+timed() {
+  local name=$1 size=$2 items=$3 input=$4 output=$5
+  shift 5
+  local start
+  start=$(now)
+  "$@" < "$input" > "$output"
+  report "$name" "$size" "$items" $(( $(now) - start ))
+}
+
+# Prints the wall time of every stage of the last profile of file $1 as
+# "<stage> <nanoseconds>" lines.
+stages() {
+  tail -n 1 "$1" | grep -o '"[A-Za-z_]*":{"calls":[0-9]*,"wall_ns":[0-9]*}' |
+    sed 's/^"\([A-Za-z_]*\)":{"calls":[0-9]*,"wall_ns":\([0-9]*\)}$/\1 \2/'
+}
+
+printf "%-48s %6s %12s %10s %14s\n" "# benchmark" size items seconds items/s
+
+mkdir -p data
+for a in $(seq 0 19); do echo "alg$a,Algorithm $a"; done > data/Alg_names.csv
+
+for s in $SIZES; do
+  # tablegenerator
+  "$BIN/gen_results" -i $((100 * s)) -a 20 -s 5 -l 10 -t 0.2 > results.csv
+  rows=$(( $(wc -l < results.csv) - 1 ))
+  echo "results.csv all_instances all_algorithms stats.csv" > params.txt
+  rm -f results.csv.cache profile.json
+  "$BIN/tablegenerator" -p params.txt -t 1 -j profile.json > /dev/null
+  stages profile.json | while read -r stage ns; do
+    report "tablegenerator.text.$stage" "$s" "$rows" "$ns"
+  done
+  "$BIN/tablegenerator" -p params.txt -t 1 -b > /dev/null
+  "$BIN/tablegenerator" -p params.txt -t 1 -j profile.json > /dev/null
+  stages profile.json | grep '^\(read_results_file\|load_archive\) ' |
+    while read -r stage ns; do
+      report "tablegenerator.cache.$stage" "$s" "$rows" "$ns"
+    done
+
+  # converters
+  n=$((10000 * s))
+  d=$(awk -v n=$n 'BEGIN { print 20 / n }')
+  "$BIN/gen_graph" -n $n -d "$d" -w int > int.txt
+  "$BIN/gen_graph" -n $n -d "$d" -w uniform > real.txt
+  "$BIN/gen_graph" -n $n -d "$d" -w int -z 0.1 > chimera.txt
+  "$BIN/gen_graph" -n $n -d "$d" -w int -B > int.bin
+  "$BIN/gen_graph" -n $n -d "$d" -w uniform -f qplib > qplib.txt
+  "$BIN/gen_graph" -n $n -d "$d" -f net > net.txt
+  m=$(head -n 1 int.txt | cut -d ' ' -f 2)
+  mz=$(head -n 1 chimera.txt | cut -d ' ' -f 2)
+  timed negate "$s" "$m" int.txt /dev/null "$BIN/negate"
+  timed negate.binary "$s" "$m" int.bin /dev/null "$BIN/negate" -b -B
+  timed scale_img "$s" "$m" real.txt /dev/null "$BIN/scale_img"
+  timed deChimera "$s" "$mz" chimera.txt /dev/null "$BIN/deChimera"
+  timed deChimera.merge "$s" "$mz" chimera.txt /dev/null "$BIN/deChimera" -m
+  timed Qubo2mc "$s" "$m" int.txt /dev/null "$BIN/Qubo2mc" -t 1
+  timed Qubo2mc.merge "$s" "$m" int.txt /dev/null "$BIN/Qubo2mc" -m -t 1
+  timed netRep2mc "$s" "$m" net.txt /dev/null "$BIN/netRep2mc"
+  timed graphbin "$s" "$m" int.txt /dev/null "$BIN/graphbin"
+  timed graphbin.decode "$s" "$m" int.bin /dev/null "$BIN/graphbin" -d
+  mi=$m
+  m=$(sed -n 5p qplib.txt | cut -d ' ' -f 1)
+  start=$(now)
+  "$BIN/qplib2mc" -t 1 qplib.txt
+  report qplib2mc "$s" "$m" $(( $(now) - start ))
+  printf "%s\n" "qubo2mc int.txt int.mc" "dechimera chimera.txt chimera.mc" \
+    "netrep2mc net.txt net.mc" "qplib2mc qplib.txt qplib.mc" > manifest.txt
+  start=$(now)
+  "$BIN/graphbatch" -t 1 manifest.txt > /dev/null
+  report graphbatch "$s" $(( 2 * mi + mz + m )) $(( $(now) - start ))
+done
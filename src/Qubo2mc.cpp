@@ -14,6 +14,27 @@
  * program then outputs the transformed graph in a format suitable for Max-Cut
  * solvers.
  *
+ * Input and output go through the buffered reader and writer of edge_io.h.
+ * The conversion itself is in converters.h, shared with graphbatch.
+ *
+ * The edges are sorted by a counting sort on the source node, which is
+ * bounded by n, and then the edges of every source node by the destination
+ * node, in parallel.  Edges with the same end nodes are kept in input order.
+ *
+ * Options:
+ *   -b: the input graph is in the binary format of edge_io.h.
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       double weights, exactly instead of with 6 significant digits.
+ *   -c: with -B, the CSR section is added to the binary graph, so that the
+ *       adjacency of every node can be used directly.
+ *   -m: the entries (i,j) and (j,i) of Q, as well as repeated ones, are
+ *       merged into a single edge (min(i,j),max(i,j)) whose weight is the sum
+ *       of their weights; the edges whose weights cancel out are dropped.
+ *       This does not change the Max-Cut instance, but makes it smaller.
+ *   -t <threads>: number of threads sorting the edges (default: 0, the
+ *       number of hardware threads).
+ *   -h: print the usage.
+ *
  * Input Format:
  *   The input is read from standard input (std::cin).
  *   - The first line contains two integers: n (size of matrix Q) and m (number
@@ -35,109 +56,78 @@
  *     node.
  *
  */
-#include <algorithm>  // For sort
+#include <unistd.h>  // For getopt
+
+#include <algorithm>  // For max
 #include <cstdlib>    // For general utilities like EXIT_SUCCESS
-#include <iostream>   // For input/output operations (cin, cout)
-#include <limits>     // For numerical limits (e.g., max of streamsize)
-#include <vector>     // For using dynamic arrays (vectors)
+#include <iostream>   // For the usage
+#include <thread>     // For the number of hardware threads
+
+#include "converters.h"  // For the conversion itself
+#include "edge_io.h"     // For buffered input/output of the edges
 
 using namespace std;  // Use the standard namespace to avoid having to write
                       // std:: repeatedly
-using Index = unsigned int;  // Define an alias 'Index' for unsigned int for
-                             // better readability
 
-// Structure to represent an edge in a graph
-struct Edge {
-  Index fr;    // 'fr' represents the 'from' node of the edge
-  Index to;    // 'to' represents the 'to' node of the edge
-  double wgt;  // 'wgt' represents the weight of the edge
-
-  // Constructor to initialize an Edge object
-  Edge(Index a, Index b, double c) : fr(a), to(b), wgt(c) {}
-};
-
-// Comparison function for sorting edges based on 'fr', then 'to'
-bool compareEdges(const Edge& a, const Edge& b) {
-  if (a.fr != b.fr) {
-    return a.fr < b.fr;  // Sort by 'fr' in ascending order
-  }
-  return a.to < b.to;  // If 'fr' is the same, sort by 'to' in ascending order
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-b] [-B] [-c] [-m] [-t <threads>] [-h]"
+       << endl;
+  cerr << " -b flag: the input graph is in the binary format" << endl;
+  cerr << " -B flag: the output graph is written in the binary format" << endl;
+  cerr << " -c flag: with -B, the CSR section is added to the output" << endl;
+  cerr << " -m flag: the entries (i,j) and (j,i) of Q, and repeated ones, are"
+       << " merged into one edge" << endl;
+  cerr << " -t <threads> (>=0) [default: 0]: number of threads sorting the "
+       << "edges; 0 stands for the number of hardware threads." << endl;
+  cerr << " -h flag: print this message." << endl;
 }
 
-// Function to skip comment lines or lines with only spaces in an input stream.
-// Comments start with '#' and extend to the end of the line.
-void skipComment(istream& f) {
-  char ch;  // Temporary character to hold the read char
-  // Read characters until a non-comment/non-space character is encountered or
-  // the end of the stream is reached.
-  while (f.get(ch) && (ch == '#' || ch == ' ')) {
-    // Ignore all characters until the end of the line.
-    f.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+int main(int argc, char** argv) {
+  bool in_binary = false, out_binary = false;  // formats of the graphs
+  bool csr = false;    // whether the CSR section is written
+  bool merge = false;  // whether the entries (i,j) and (j,i) are merged
+  int n_threads = 0;   // threads sorting the edges
+  int opt;
+  while ((opt = getopt(argc, argv, "bBcmt:h")) != -1) {
+    switch (opt) {
+      case 'b':
+        in_binary = true;
+        break;
+      case 'B':
+        out_binary = true;
+        break;
+      case 'c':
+        csr = true;
+        break;
+      case 'm':
+        merge = true;
+        break;
+      case 't':
+        n_threads = atoi(optarg);
+        break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
   }
-  // If a non-comment/non-space character was found, put it back into the
-  // stream.
-  if (f.good()) {
-    f.unget();
+  if (optind != argc || n_threads < 0 || (csr && !out_binary)) {
+    if (csr && !out_binary) cerr << "*** -c requires -B" << endl;
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
   }
-}
+  if (n_threads == 0) n_threads = max(1u, thread::hardware_concurrency());
 
-int main() {
-  int n, m;  // 'n' represents the number of nodes, 'm' represents the number of
-             // edges in the QUBO instance. As said, matrix Q is interpreted as
-             // an undirected weighted graph with n nodes and possibly loops
-
-  skipComment(std::cin);  // Skip any leading comments or blank lines in the
-                          // standard input
-
-  cin >> n >> m;  // Read the number of nodes and edges from the input
-
-  vector<double> nodeSum(n, 0.0);  // Initialize a vector 'nodeSum' of
-                                   // size 'n' with all elements set
-                                   // to 0.0. This vector will store
-                                   // the sum of weights of edges
-                                   // connected to each node.
-  vector<Edge> E;  // Initialize an empty vector 'E' to store the edges
-
-  // Loop through each edge in the input (QUBO instance)
-  for (Index k = 0; k != m; ++k) {
-    Index i, j;  // 'i' and 'j' represent the nodes connected by the edge
-    double w;    // 'w' represents the weight of the edge
-    cin >> i >> j >> w;  // Read the edge information (nodes and weight)
-    --i;                 // Adjust node indices to be 0-based (input is 1-based)
-    --j;                 // Adjust node indices to be 0-based (input is 1-based)
-    if (i != j) {        // If it's not a self-loop (i.e., a regular edge)
-      E.push_back(
-          Edge(i + 1, j + 1, w));  // Add the edge to the 'E' vector (nodes are
-                                   // stored as 1-based for output)
-      nodeSum[i] += w;             // Add the weight to the sum for node 'i'
-      nodeSum[j] += w;             // Add the weight to the sum for node 'j'
-    } else {                       // If it's a self-loop (i.e., i == j)
-      nodeSum[i] +=
-          1.0 * w;  // Add the weight to the sum for node 'i' (self-loop)
-    }
+  try {
+    GraphInput in(in_binary);     // the standard input
+    GraphOutput out(out_binary);  // the standard output
+    qubo2mc(in, out, csr, merge, [n_threads]() -> unsigned {
+      return n_threads;
+    });
+  } catch (const GraphError& e) {
+    cerr << "Error: " << e.what() << endl;
+    exit(EXIT_FAILURE);
   }
 
-  // Add new edges to connect each node to a new node (node 0) based on nodeSum
-  for (Index k = 0; k != n; ++k)
-    // if the weight is not close to zero (avoiding adding edges with negligible
-    // weights)
-    if (nodeSum[k] < -1.0e-12 || nodeSum[k] > 1.0e-12)
-      E.push_back(Edge(
-          0, k + 1, -nodeSum[k]));  // Add an edge from node 0 to node k+1 with
-                                    // weight -nodeSum[k] This is the core of
-                                    // the QUBO to Max-Cut transformation.
-
-  cout << n + 1 << " " << E.size()
-       << endl;  // Output the number of nodes (n+1, including the new node 0)
-                 // and the number of edges
-
-  sort(E.begin(), E.end(),
-       compareEdges);  // Sort the edges based on the 'compareEdges' function
-
-  // Output the edges in the sorted order
-  for (Index k = 0; k != E.size(); ++k)
-    cout << E[k].fr + 1 << " " << E[k].to + 1 << " " << E[k].wgt
-         << endl;  // Output the edge information (1-based indexing)
-
   return EXIT_SUCCESS;  // Indicate successful execution
 }
@@ -0,0 +1,166 @@
+/**
+ * @file best_known.h
+ * @brief Best known value of every instance, as found by tablegenerator,
+ * in CSV and in a memory-mappable binary form.
+ *
+ * For every instance the index holds the best value reached by any
+ * algorithm and seed within the time limits, the earliest time it was
+ * reached at, the algorithm and the seed reaching it at that time (the
+ * first algorithm in the results file, and its first seed, on ties), and
+ * the number of algorithms reaching it with some seed.  It is meant to
+ * give the target values and the warm starts of new runs.
+ *
+ * The CSV has a header line and one row per instance:
+ *   Instance,BestValue,Time,Algorithm,Seed,Reached
+ * with the values and times written exactly (see Decimal::to_string).
+ *
+ * Binary index layout (see section_file.h), meant to be read in place by
+ * other programs, e.g. solvers: all integers are in native byte order and
+ * all floating-point numbers are IEEE 754 doubles.
+ *   - an IndexHeader of 192 bytes:
+ *       magic "TGBESTKN" (8 bytes), version (uint32, 2), byte order marker
+ *       (uint32, 0x01020304), size (uint64) and modification time (int64,
+ *       in ns) of the results file, time scaling (double), number of
+ *       instances N (uint64), then the offset and the size in bytes of
+ *       every section, as two arrays of kSections uint64;
+ *   - kSections sections, each at an offset multiple of 64 bytes:
+ *       the names of the instances, of the algorithms and of the seeds,
+ *       each as N + 1 uint64 offsets followed by a section of characters,
+ *       name k being chars[off[k], off[k+1]); the values (N doubles); the
+ *       times (N doubles); the numbers of algorithms reaching the values
+ *       (N uint32).
+ * Unlike those of the CSV, the values and times of the binary index are
+ * rounded to the nearest double.
+**/
+
+#ifndef BEST_KNOWN_H
+#define BEST_KNOWN_H
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "decimal.h"
+#include "results_archive.h"  // For the string columns
+#include "section_file.h"
+
+//-------------------------------------------------------------------
+class BestKnownIndex {
+ public:
+  static constexpr std::uint32_t kVersion = 2;
+
+  // Index of every section in the binary index.
+  enum Section {
+    kInstNameOff,
+    kInstNameChars,
+    kAlgNameOff,
+    kAlgNameChars,
+    kSeedNameOff,
+    kSeedNameChars,
+    kValue,
+    kTime,
+    kReached,
+    kSections
+  };
+
+  struct IndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t source_size;
+    std::int64_t source_mtime_ns;
+    double scaling;
+    std::uint64_t n_instances;
+    std::uint64_t section_offset[kSections];
+    std::uint64_t section_size[kSections];
+  };
+  static_assert(sizeof(IndexHeader) == 192,
+                "the header of the best known index has no padding");
+
+  double scaling = 1.0;  // scaling of the time limits
+
+  std::size_t size() const { return value.size(); }
+
+  // Name of the binary index associated to a CSV index.
+  static std::string index_name(const std::string& csv) {
+    return csv + ".idx";
+  }
+
+  // Appends the best known value of an instance.
+  void push_back(std::string_view instance, const Decimal& v,
+                 const Decimal& t, std::string_view algorithm,
+                 std::string_view seed, std::uint32_t n_reached) {
+    inst_names.push_back(instance);
+    alg_names.push_back(algorithm);
+    seed_names.push_back(seed);
+    value.push_back(v);
+    time.push_back(t);
+    reached.push_back(n_reached);
+  }
+
+  // Writes the index as a CSV.
+  void write_csv(std::ostream& out) const {
+    StringColumn inst = inst_names.view(), alg = alg_names.view(),
+                 seed = seed_names.view();
+    out << "Instance,BestValue,Time,Algorithm,Seed,Reached\n";
+    for (std::size_t k = 0; k != size(); ++k)
+      out << inst[k] << ',' << value[k].to_string() << ','
+          << time[k].to_string() << ',' << alg[k] << ',' << seed[k] << ','
+          << reached[k] << '\n';
+    out.flush();
+  }
+
+  //-----------------------------------------------------------------
+  // Writes the index as a binary index computed from the results file
+  // source.  Returns false if it cannot be written.
+  bool write_index(const std::string& filename,
+                   const std::string& source) const {
+    IndexHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.endian = kEndian;
+    if (!source_stat(source, header.source_size, header.source_mtime_ns))
+      return false;
+    header.scaling = scaling;
+    header.n_instances = size();
+
+    std::vector<double> value_d(size()), time_d(size());
+    for (std::size_t k = 0; k != size(); ++k) {
+      value_d[k] = value[k].to_double();
+      time_d[k] = time[k].to_double();
+    }
+    const void* data[kSections];
+    const StringColumnBuilder* names[] = {&inst_names, &alg_names,
+                                          &seed_names};
+    for (int c = 0; c != 3; ++c) {
+      data[2 * c] = names[c]->off.data();
+      data[2 * c + 1] = names[c]->chars.data();
+      header.section_size[2 * c] = names[c]->off.size() * sizeof(std::uint64_t);
+      header.section_size[2 * c + 1] = names[c]->chars.size();
+    }
+    data[kValue] = value_d.data();
+    data[kTime] = time_d.data();
+    data[kReached] = reached.data();
+    header.section_size[kValue] = size() * sizeof(double);
+    header.section_size[kTime] = size() * sizeof(double);
+    header.section_size[kReached] = size() * sizeof(std::uint32_t);
+    layout_sections(sizeof(header), kSections, header.section_size,
+                    header.section_offset);
+    return write_sections(filename, &header, sizeof(header), kSections, data,
+                          header.section_offset, header.section_size);
+  }
+
+ private:
+  static constexpr char kMagic[8] = {'T', 'G', 'B', 'E', 'S', 'T', 'K', 'N'};
+  static constexpr std::uint32_t kEndian = 0x01020304;
+
+  // the columns, one element per instance
+  StringColumnBuilder inst_names, alg_names, seed_names;
+  std::vector<Decimal> value, time;
+  std::vector<std::uint32_t> reached;
+};
+
+#endif  // BEST_KNOWN_H
@@ -0,0 +1,640 @@
+/**
+ * @file converters.h
+ * @brief The conversions of Qubo2mc, deChimera, netRep2mc and qplib2mc, as
+ * functions from an input to an output graph.
+ *
+ * Every program parses its options and calls its conversion on its files;
+ * graphbatch calls the same conversions on the files of a manifest, so that
+ * the outputs are the same, byte for byte, as the ones of the programs.
+ * See the programs for the formats and the options.  The conversions throw
+ * a GraphError (see edge_io.h) on invalid inputs and on outputs that cannot
+ * be written; the programs print its message and exit.
+ *
+ * Every conversion returns a ConversionStats with the size of the graph it
+ * wrote and the number of isolated nodes it removed (only deChimera removes
+ * any).
+**/
+
+#ifndef CONVERTERS_H
+#define CONVERTERS_H
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "edge_io.h"
+
+using Index = unsigned int;
+
+// What a conversion did.
+struct ConversionStats {
+  std::uint64_t n = 0;         // number of nodes of the output graph
+  std::uint64_t m = 0;         // number of edges of the output graph
+  std::uint64_t isolated = 0;  // isolated nodes removed
+};
+
+// Removes the output file name of a conversion that failed after creating
+// it, if it is a regular file (not, e.g., /dev/null).
+inline void removeOutput(const std::string& name) {
+  struct stat st;
+  if (stat(name.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+    unlink(name.c_str());
+}
+
+//-------------------------------------------------------------------
+// Qubo2mc
+
+// Structure to represent an edge in a graph
+struct Edge {
+  Index fr;    // 'fr' represents the 'from' node of the edge
+  Index to;    // 'to' represents the 'to' node of the edge
+  double wgt;  // 'wgt' represents the weight of the edge
+
+  // Constructor to initialize an Edge object
+  Edge(Index a, Index b, double c) : fr(a), to(b), wgt(c) {}
+};
+
+// The number of threads sorting the edges of a conversion, asked when it
+// sorts them: a constant for the converters and, for graphbatch, its
+// threads shared among the conversions still running.
+using SortThreads = std::function<unsigned()>;
+
+// A graph in memory, as passed between the stages of graphpipe: its n
+// nodes are 1-based and its edges go from node fr to node to.
+struct Graph {
+  Index n = 0;
+  std::vector<Edge> E;
+};
+
+// Offsets of the edges of every source node in E sorted by 'fr': the edges
+// of node v (0 <= v <= n) are E[off[v]], ..., E[off[v + 1] - 1].
+inline std::vector<std::uint64_t> nodeOffsets(const std::vector<Edge>& E,
+                                              Index n) {
+  std::vector<std::uint64_t> off(n + 2, 0);
+  for (const Edge& e : E) ++off[e.fr + 1];
+  for (Index v = 0; v <= n; ++v) off[v + 1] += off[v];
+  return off;
+}
+
+// Sorts the edges first by 'fr' and then by 'to', keeping the edges with
+// the same end nodes in input order.  Since 'fr' is at most n, the edges
+// are distributed among the source nodes by a counting sort; the edges
+// of every source node are then sorted by 'to', the nodes being split
+// among n_threads threads so that each one sorts about as many edges.
+inline void sortEdges(std::vector<Edge>& E, Index n, unsigned n_threads) {
+  std::vector<std::uint64_t> off = nodeOffsets(E, n);
+  {
+    std::vector<std::uint64_t> next(off.begin(), off.end() - 1);
+    std::vector<Edge> sorted(E.size(), Edge(0, 0, 0.0));
+    for (const Edge& e : E) sorted[next[e.fr]++] = e;
+    E.swap(sorted);
+  }  // the unsorted edges are freed
+
+  auto run = [&](Index first, Index last) {
+    for (Index v = first; v != last; ++v)
+      std::stable_sort(
+          E.begin() + off[v], E.begin() + off[v + 1],
+          [](const Edge& a, const Edge& b) { return a.to < b.to; });
+  };
+  unsigned n_workers = std::max(1u, std::min<unsigned>(n_threads, n + 1));
+  std::vector<std::thread> workers;
+  Index first = 0;
+  for (unsigned w = 0; w != n_workers; ++w) {
+    std::uint64_t target = E.size() * (w + 1) / n_workers;
+    Index last = w + 1 == n_workers
+                     ? n + 1
+                     : std::lower_bound(off.begin() + first,
+                                        off.begin() + n + 1, target) -
+                           off.begin();
+    workers.emplace_back(run, first, last);
+    first = last;
+  }
+  for (std::thread& worker : workers) worker.join();
+}
+
+// Merges the consecutive edges of the sorted E with the same end nodes
+// into one, whose weight is the sum of their weights, and drops those of
+// weight 0.
+inline void mergeEdges(std::vector<Edge>& E) {
+  std::size_t k = 0;  // the merged edges are E[0, k)
+  for (std::size_t s = 0; s != E.size();) {
+    double w = 0.0;
+    std::size_t t = s;
+    for (; t != E.size() && E[t].fr == E[s].fr && E[t].to == E[s].to; ++t)
+      w += E[t].wgt;
+    if (w != 0.0) E[k++] = Edge(E[s].fr, E[s].to, w);
+    s = t;
+  }
+  E.erase(E.begin() + k, E.end());
+}
+
+// QUBO to Max-Cut on a graph in memory: g holds the entries of Q, an
+// undirected weighted graph with possibly loops, and is replaced by the
+// Max-Cut instance, with a new node 1, the others being shifted by one.
+// The edges are sorted by sort_threads() threads and, if merge, the
+// entries (i,j) and (j,i) are merged.
+inline void quboToMaxCut(Graph& g, bool merge,
+                         const SortThreads& sort_threads) {
+  Index n = g.n;
+  std::vector<double> nodeSum(n, 0.0);  // Initialize a vector 'nodeSum' of
+                                        // size 'n' with all elements set
+                                        // to 0.0. This vector will store
+                                        // the sum of weights of edges
+                                        // connected to each node.
+  std::vector<Edge>& E = g.E;
+  std::size_t k = 0;  // the entries not on the diagonal are E[0, k)
+
+  // Loop through each entry of Q
+  for (std::size_t s = 0; s != E.size(); ++s) {
+    Index i = E[s].fr - 1;  // Adjust node indices to be 0-based (input is
+    Index j = E[s].to - 1;  // 1-based)
+    double w = E[s].wgt;    // 'w' represents the weight of the edge
+    if (i >= n || j >= n)
+      throw GraphError("node out of range in entry " + std::to_string(i + 1) +
+                       " " + std::to_string(j + 1));
+    if (i != j) {        // If it's not a self-loop (i.e., a regular edge)
+      if (merge && i > j) std::swap(i, j);  // (i,j) and (j,i) are the same
+                                            // edge
+      E[k++] = Edge(i + 1, j + 1, w);  // Keep the edge (nodes are stored as
+                                       // 1-based, node 0 being the new one)
+      nodeSum[i] += w;             // Add the weight to the sum for node 'i'
+      nodeSum[j] += w;             // Add the weight to the sum for node 'j'
+    } else {                       // If it's a self-loop (i.e., i == j)
+      nodeSum[i] +=
+          1.0 * w;  // Add the weight to the sum for node 'i' (self-loop)
+    }
+  }
+  E.erase(E.begin() + k, E.end());
+
+  // Add new edges to connect each node to a new node (node 0) based on nodeSum
+  for (Index k = 0; k != n; ++k)
+    // if the weight is not close to zero (avoiding adding edges with negligible
+    // weights)
+    if (nodeSum[k] < -1.0e-12 || nodeSum[k] > 1.0e-12)
+      E.push_back(Edge(
+          0, k + 1, -nodeSum[k]));  // Add an edge from node 0 to node k+1 with
+                                    // weight -nodeSum[k] This is the core of
+                                    // the QUBO to Max-Cut transformation.
+
+  sortEdges(E, n, sort_threads());  // Sort the edges by 'fr', then by 'to'
+  if (merge) mergeEdges(E);    // Merge the edges with the same end nodes
+
+  // the nodes of the output are 1-based, node 1 being the new one
+  for (Edge& e : E) {
+    ++e.fr;
+    ++e.to;
+  }
+  g.n = n + 1;
+}
+
+// Converts the QUBO instance read from in to the Max-Cut instance written
+// to out, with the CSR section if csr and merging the entries (i,j) and
+// (j,i) if merge; the edges are sorted by sort_threads() threads.
+inline ConversionStats qubo2mc(GraphInput& in, GraphOutput& out, bool csr,
+                               bool merge, const SortThreads& sort_threads) {
+  Index m;  // the number of entries of Q, matrix Q being interpreted as an
+            // undirected weighted graph with g.n nodes and possibly loops
+  Graph g;
+
+  in.skip_comments('#');  // Skip any leading comments or blank lines in the
+                          // input
+
+  in.read_header(g.n, m);  // Read the number of nodes and edges from the
+                           // input
+  g.E.reserve(static_cast<std::size_t>(m) + g.n);  // at most m edges and n
+                                                   // added ones
+  // Read each entry of Q (nodes and weight)
+  for (Index k = 0; k != m; ++k) {
+    Index i, j;
+    double w;
+    in.read_edge(i, j, w);
+    g.E.push_back(Edge(i, j, w));
+  }
+
+  quboToMaxCut(g, merge, sort_threads);
+
+  // Output the number of nodes (n+1, including the new node) and the
+  // number of edges
+  out.write_header(g.n, g.E.size(), kWeightDouble, csr ? kGraphHasCSR : 0);
+
+  // Output the edges in the sorted order
+  for (const Edge& e : g.E) out.write_edge(e.fr, e.to, e.wgt);
+
+  if (csr) {  // Output the offsets of the edges of every node
+    std::vector<std::uint64_t> off(g.n + 1, 0);
+    for (const Edge& e : g.E) ++off[e.fr];
+    for (Index v = 0; v != g.n; ++v) off[v + 1] += off[v];
+    out.writer().write_bytes(off.data(), off.size() * sizeof(off[0]));
+  }
+
+  ConversionStats stats;
+  stats.n = g.n;
+  stats.m = g.E.size();
+  return stats;
+}
+
+//-------------------------------------------------------------------
+// deChimera
+
+// The edges as a structure of arrays: edge e goes from node fr[e] to node
+// to[e] (0-based) and has weight wgt[e].
+struct Edges {
+  std::vector<Index> fr;
+  std::vector<Index> to;
+  std::vector<double> wgt;
+
+  std::size_t size() const { return wgt.size(); }
+  void reserve(std::size_t m) {
+    fr.reserve(m);
+    to.reserve(m);
+    wgt.reserve(m);
+  }
+  void push_back(Index f, Index t, double w) {
+    fr.push_back(f);
+    to.push_back(t);
+    wgt.push_back(w);
+  }
+  void resize(std::size_t m) {
+    fr.resize(m);
+    to.resize(m);
+    wgt.resize(m);
+  }
+};
+
+// Stable counting sort of the edges E, whose nodes are < n, by key[e]
+// (E.fr or E.to); tmp is used as buffer.
+inline void countingSort(Edges& E, const std::vector<Index> Edges::*key,
+                         Index n, Edges& tmp) {
+  const std::vector<Index>& K = E.*key;
+  std::vector<std::size_t> next(n + 1, 0);  // the next position of every key
+  for (Index k : K) ++next[k + 1];
+  for (Index v = 0; v != n; ++v) next[v + 1] += next[v];
+  tmp.resize(E.size());
+  for (std::size_t e = 0; e != E.size(); ++e) {
+    std::size_t p = next[K[e]]++;
+    tmp.fr[p] = E.fr[e];
+    tmp.to[p] = E.to[e];
+    tmp.wgt[p] = E.wgt[e];
+  }
+  std::swap(E, tmp);
+}
+
+// Merges the parallel edges of E, whose nodes are < n and such that
+// fr[e] <= to[e]: they are sorted by (fr, to) and the consecutive edges
+// with the same end nodes are replaced by their sum, dropped if it is 0.
+inline void mergeEdges(Edges& E, Index n) {
+  {
+    Edges tmp;
+    countingSort(E, &Edges::to, n, tmp);
+    countingSort(E, &Edges::fr, n, tmp);
+  }  // the buffer is freed
+  std::size_t k = 0;  // the merged edges are [0, k)
+  for (std::size_t s = 0; s != E.size();) {
+    double w = 0.0;
+    std::size_t t = s;
+    for (; t != E.size() && E.fr[t] == E.fr[s] && E.to[t] == E.to[s]; ++t)
+      w += E.wgt[t];
+    if (w != 0) {
+      E.fr[k] = E.fr[s];
+      E.to[k] = E.to[s];
+      E.wgt[k] = w;
+      ++k;
+    }
+    s = t;
+  }
+  E.resize(k);
+}
+
+// Adds the edge from node f to node t (1-based) of weight w of a graph of
+// n nodes to E, with 0-based nodes and ordered end nodes if merge, unless
+// its weight is 0.
+inline void addNonZeroEdge(Edges& E, Index n, Index f, Index t, double w,
+                           bool merge) {
+  if (f - 1 >= n || t - 1 >= n)
+    throw GraphError("node out of range in edge " + std::to_string(f) + " " +
+                     std::to_string(t));
+  if (w != 0) {             // check if w is different than 0
+    if (merge && f > t) std::swap(f, t);  // (f,t) and (t,f) are the same
+                                          // edge
+    E.push_back(f - 1, t - 1,
+                w);  // store the edge, decrementing f and t to 0 based
+                     // index
+  }
+}
+
+// Removes the isolated nodes of the graph of n nodes whose edges, of
+// weights other than 0, are E (added by addNonZeroEdge), merging the
+// parallel edges first if merge.  The nodes left are renumbered and the
+// end nodes of every edge ordered.  Returns the number of nodes left.
+inline Index removeIsolated(Edges& edges, Index n, bool merge) {
+  if (merge) mergeEdges(edges, n);  // Merge the parallel edges
+
+  std::vector<Index> degree(
+      n,
+      0);  // Create a vector 'degree' of size 'n', initialized with zeros.
+           // degree[i] will store the degree (number of connections) of node i.
+  for (std::size_t e = 0; e != edges.size(); ++e) {
+    ++degree[edges.fr[e]];  // Increment the degree of the source node.
+    ++degree[edges.to[e]];  // Increment the degree of the destination node.
+  }
+
+  std::vector<Index> name(n);  // Create a vector 'name' of size 'n'.
+                               // 'name' will store the new indices of the
+                               // nodes after removing isolated nodes.
+  Index new_n =
+      0;  // Initialize a counter for the number of non-isolated nodes.
+  // Iterate through each node
+  for (Index k = 0; k != n; ++k) {
+    if (degree[k] >
+        0) {  // Check if the degree of node k is greater than 0 (not isolated).
+      name[k] =
+          new_n++;  // Assign a new index to node k and increment the counter.
+    }
+  }
+
+  // Iterate through each edge
+  for (std::size_t e = 0; e != edges.size(); ++e) {
+    Index f = name[edges.fr[e]];  // Get the new index of the source node
+                                  // from the name array
+    Index t = name[edges.to[e]];  // Get the new index of the destination
+                                  // node from the name array
+    if (f > t) {  // Ensure that the source node index is always less than or
+                  // equal to the destination node index.
+      std::swap(f, t);  // Use std::swap for efficiency if f > t.
+    }
+    edges.fr[e] = f;
+    edges.to[e] = t;
+  }
+  return new_n;
+}
+
+// Removes the edges of weight 0 and the isolated nodes of the graph read
+// from in, merging the parallel edges first if merge, and writes the
+// result to out.
+inline ConversionStats deChimera(GraphInput& in, GraphOutput& out,
+                                 bool merge) {
+  Index n, m;  // n: number of nodes, m: number of edges
+
+  // read input graph
+  in.skip_comments('#');  // Skip any leading comments or blank lines in the
+                          // input
+  in.read_header(n, m);  // Read the number of nodes (n) and edges (m) from
+                         // the input
+
+  Edges edges;  // Store the edges: edge e goes from edges.fr[e] to
+                // edges.to[e] and has weight edges.wgt[e]
+
+  edges.reserve(m);  // Pre-allocate space for 'm' edges in the 'edges' arrays
+                     // to avoid frequent reallocations
+
+  // Loop through each edge
+  for (Index e = 0; e != m; ++e) {
+    Index f, t;               // f: source node, t: destination node
+    double w;                 // w: weight of the edge
+    in.read_edge(f, t, w);    // Read the source node, destination node, and
+                              // weight of the current edge
+    addNonZeroEdge(edges, n, f, t, w, merge);
+  }
+  Index new_n = removeIsolated(edges, n, merge);
+
+  out.write_header(new_n, edges.size());  // Output the new number of nodes
+                                          // (non-isolated) and the number
+                                          // of edges
+
+  // Output the edges (source, destination, weight), incrementing the nodes
+  // to 1 based index
+  for (std::size_t e = 0; e != edges.size(); ++e)
+    out.write_edge(edges.fr[e] + 1, edges.to[e] + 1, edges.wgt[e]);
+
+  ConversionStats stats;
+  stats.n = new_n;
+  stats.m = edges.size();
+  stats.isolated = n - new_n;
+  return stats;
+}
+
+//-------------------------------------------------------------------
+// netRep2mc
+
+// Converts the network read from in to the graph written to out, with
+// weight 1 on every edge.
+inline ConversionStats netRep2mc(EdgeReader& in, GraphOutput& out) {
+  Index n1, n2, m;  // n1 and n2: Number of nodes, m: Number of edges
+  int i, j;         // i, j: Node indices
+
+  in.skip_comments('%');  // Skip any leading comments or blank lines in the
+                          // input
+
+  // Read the number of nodes (n) and edges (m) from the input.
+  in.read(n1, n2, m);
+
+  // Output the number of nodes and edges to the output.
+  out.write_header(n1, m, kWeightInt64);
+
+  // Iterate through each of the 'm' edges.
+  for (Index k = 0; k != m; ++k) {
+    // Read the source node (i) and destination node (j) of the edge.
+    in.read(i, j);
+
+    // Output the source node (i), destination node (j), and weight 1
+    out.write_edge(i, j, 1);
+  }
+
+  ConversionStats stats;
+  stats.n = n1;
+  stats.m = m;
+  return stats;
+}
+
+//-------------------------------------------------------------------
+// qplib2mc
+
+// The beginning of a qplib instance, up to its edges.
+struct QplibHead {
+  std::string name;  // the name of the instance, on its first line
+  int n;             // the number of nodes
+  int m;             // the number of edges
+};
+
+// Reads the beginning of a qplib instance.  Comments are skipped after the
+// values, as by the skipComment function of the converters.
+inline QplibHead readQplibHead(EdgeReader& in) {
+  QplibHead h;
+  std::string line;
+  // Read the first line (usually the filename).
+  in.getline(h.name);
+  // Skip the second and third lines of the input (as per the problem's
+  // specification).
+  in.getline(line);
+  in.getline(line);
+  // Read the number of nodes 'n' and the number of edges 'm'.
+  in.read(h.n);
+  in.skip_comments('#');
+  in.read(h.m);
+  in.skip_comments('#');
+  return h;
+}
+
+// Reads an edge of a qplib instance, with 0-based end nodes u and v; the
+// weight c is half the one of the input.
+inline void readQplibEdge(EdgeReader& in, const QplibHead& h, int& u, int& v,
+                          double& c) {
+  double w;
+  in.read(u, v, w);  // Read the source node, destination node, and weight.
+  --u;               // Adjust the node indices to be 0-based (input is
+  --v;               // 1-based).
+  // Check if the node indices are within the valid range.
+  if (u < 0 || u >= h.n || v < 0 || v >= h.n)
+    throw GraphError("node out of range in edge " + std::to_string(u + 1) +
+                     " " + std::to_string(v + 1));
+  c = w / 2;
+}
+
+// Reads the diagonal of a qplib instance, after its edges, whose halved
+// weights add up to Sum[i] at node i.  Returns the value -2 * Diag[i] -
+// Sum[i] of every node i, that qplib2mc writes as an edge to a dummy node
+// if it is not 0.
+inline std::vector<double> readQplibLoops(EdgeReader& in, const QplibHead& h,
+                                          const std::vector<double>& Sum) {
+  int n = h.n;
+  double z;  // Variable to store the initial diagonal value.
+  int nd;    // Variable to store the number of additional diagonal entries.
+
+  // Read the initial diagonal value 'z' and fill the 'Diag' vector with it.
+  in.read(z);
+  in.skip_comments('#');
+  std::vector<double> Diag(n, z);
+
+  // Read the additional diagonal entries and update the 'Diag' vector.
+  in.read(nd);
+  in.skip_comments('#');
+  for (int i = 0; i < nd; ++i) {
+    int u;     // Temporary variable for the node index.
+    double w;  // Temporary variable for the diagonal value.
+    in.read(u, w);
+    if (u < 1 || u > n)
+      throw GraphError("node out of range in diagonal entry " +
+                       std::to_string(u));
+    Diag[u - 1] = w;
+  }
+
+  // The diagonal value of the i-th node is -2 * Diag[i] - Sum[i].
+  for (int i = 0; i < n; ++i) Diag[i] = -2 * Diag[i] - Sum[i];
+  return Diag;
+}
+
+// Reads the rest of a qplib instance whose beginning h has been read and
+// converts it, in memory, as qplib2mc does: the edges are followed by the
+// loops, as edges to the dummy node n + 1.
+inline Graph readQplibGraph(EdgeReader& in, const QplibHead& h) {
+  std::vector<double> Sum(h.n, 0.0);
+  Graph g;
+  g.E.reserve(h.m);
+  for (int i = 0; i < h.m; ++i) {
+    int u, v;
+    double ci;
+    readQplibEdge(in, h, u, v, ci);
+    Sum[u] += ci;  // Add half the weight to the sums of weights of the
+    Sum[v] += ci;  // source and of the destination node.
+    g.E.push_back(Edge(u + 1, v + 1, -ci / 2.0));
+  }
+  std::vector<double> loop = readQplibLoops(in, h, Sum);
+  for (int i = 0; i < h.n; ++i)
+    if (loop[i] != 0.0) g.E.push_back(Edge(i + 1, h.n + 1, -loop[i] / 2.0));
+  // If there are any loops, the dummy node is added.
+  g.n = g.E.size() > static_cast<std::size_t>(h.m) ? h.n + 1 : h.n;
+  return g;
+}
+
+// Converts the qplib instance read from fd, named source in the error
+// messages, to the file nameOut or, if empty, to the file named after the
+// instance with ".txt" (".bin" if out_binary) appended.  The output is
+// only created once the first pass is done; if the conversion fails after
+// that, it is removed.
+inline ConversionStats qplib2mc(int fd, const std::string& source,
+                                bool out_binary, std::string nameOut = "") {
+  // the start of the input, to read it a second time
+  off_t start = lseek(fd, 0, SEEK_CUR);
+  bool twice = start != -1;
+
+  EdgeReader in(fd);
+  QplibHead h = readQplibHead(in);
+  Graph g;  // the whole graph, only if the input cannot be read twice
+  std::vector<double> loop;  // the loops, if it can
+  if (twice) {
+    // 'Sum[i]' will store the sum of weights connected to node 'i'.
+    std::vector<double> Sum(h.n, 0.0);
+    for (int i = 0; i < h.m; ++i) {
+      int u, v;
+      double ci;
+      readQplibEdge(in, h, u, v, ci);
+      Sum[u] += ci;  // Add half the weight to the sums of weights of the
+      Sum[v] += ci;  // source and of the destination node.
+    }
+    loop = readQplibLoops(in, h, Sum);
+  } else {
+    g = readQplibGraph(in, h);
+  }
+
+  // Open the output file.
+  if (nameOut.empty()) nameOut = h.name + (out_binary ? ".bin" : ".txt");
+  int out_fd = open(nameOut.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0)
+    throw GraphError("cannot open " + nameOut + " for " + source);
+  ConversionStats stats;
+  try {
+    GraphOutput out(out_binary, out_fd);
+
+    if (twice) {
+      int n = h.n;
+      int nd = 0;  // the number of loops, added as edges to a dummy node
+      for (int i = 0; i < n; ++i)
+        if (loop[i] != 0.0) ++nd;
+      // If there are any loops, increment n to account for the dummy node.
+      stats.n = nd > 0 ? n + 1 : n;
+      stats.m = h.m + nd;
+      out.write_header(stats.n, stats.m);
+
+      // Write the edge data to the output file, reading it again.
+      if (lseek(fd, start, SEEK_SET) != start)
+        throw GraphError("cannot read " + source + " again");
+      EdgeReader again(fd);
+      readQplibHead(again);
+      for (int i = 0; i < h.m; ++i) {
+        int u, v;
+        double ci;
+        readQplibEdge(again, h, u, v, ci);
+        out.write_edge(u + 1, v + 1, -ci / 2.0);
+      }
+
+      // Write the loops to the output file.
+      for (int i = 0; i < n; ++i)
+        if (loop[i] != 0.0) out.write_edge(i + 1, n + 1, -loop[i] / 2.0);
+    } else {
+      stats.n = g.n;
+      stats.m = g.E.size();
+      out.write_header(stats.n, stats.m);
+      for (const Edge& e : g.E) out.write_edge(e.fr, e.to, e.wgt);
+    }
+  } catch (...) {  // the output, incomplete, is removed
+    close(out_fd);
+    removeOutput(nameOut);
+    throw;
+  }  // the output is flushed
+
+  // Close the output file.
+  close(out_fd);
+  return stats;
+}
+
+#endif  // CONVERTERS_H
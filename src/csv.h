@@ -0,0 +1,81 @@
+/**
+ * @file csv.h
+ * @brief Allocation-free splitting and conversion of the fields of CSV lines.
+ *
+ * The results file read by tablegenerator and the summary file read by
+ * extract are comma-separated text files with many rows.  The functions
+ * below work on std::string_view's of the lines: fields are never copied and
+ * numbers are converted with std::from_chars, so that parsing a row performs
+ * no memory allocation.
+**/
+
+#ifndef CSV_H
+#define CSV_H
+
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+//-------------------------------------------------------------------
+// Splits a line into the fields separated by delimiter.  A line with k
+// delimiters has k + 1 fields, the empty ones included.
+class FieldReader {
+ public:
+  explicit FieldReader(std::string_view line, char delimiter = ',')
+      : rest(line), delimiter(delimiter) {}
+
+  // Stores the next field of the line in field.  Returns false if all the
+  // fields have been read.
+  bool next(std::string_view& field) {
+    if (done) return false;
+    std::size_t pos = rest.find(delimiter);
+    if (pos == std::string_view::npos) {
+      field = rest;
+      rest = std::string_view();
+      done = true;
+    } else {
+      field = rest.substr(0, pos);
+      rest.remove_prefix(pos + 1);
+    }
+    return true;
+  }
+
+ private:
+  std::string_view rest;
+  char delimiter;
+  bool done = false;
+};
+
+//-------------------------------------------------------------------
+// Skips the leading blanks and the plus sign accepted by stod and stoi, but
+// not by std::from_chars.
+inline std::string_view number_prefix(std::string_view s) {
+  std::size_t i = 0;
+  while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' ||
+                          s[i] == '\r' || s[i] == '\f' || s[i] == '\v'))
+    ++i;
+  if (i + 1 < s.size() && s[i] == '+' && s[i + 1] != '-') ++i;
+  return s.substr(i);
+}
+
+// Converts the longest prefix of s which is a number, the way stod and stoi
+// do.  Returns false if no conversion can be performed.
+template <class T>
+bool parse_number(std::string_view s, T& value) {
+  s = number_prefix(s);
+  std::from_chars_result res = std::from_chars(s.data(), s.data() + s.size(),
+                                               value);
+  return res.ec == std::errc();
+}
+
+// Parses a double the way stod does, but returns NaN instead of throwing
+// when no conversion can be performed.
+inline double parse_double(std::string_view s) {
+  double v;
+  if (!parse_number(s, v)) return std::numeric_limits<double>::quiet_NaN();
+  return v;
+}
+
+#endif  // CSV_H
@@ -28,6 +28,28 @@
  * 9. Skips comment lines or lines with only spaces in the input stream.
  * 10. Ignores edges with a weight of 0.
  *
+ * Input and output go through the buffered reader and writer of edge_io.h.
+ * The edges are stored as a structure of arrays (end nodes and weights).
+ * The conversion itself is in converters.h, shared with graphbatch.
+ *
+ * With option -m, parallel edges are merged: every edge is written as
+ * (min, max) of its end nodes and the edges are sorted by these pairs, with
+ * two counting sorts (by the second end node, then by the first one), since
+ * the nodes are bounded by n.  The edges with the same end nodes, which are
+ * then consecutive, are replaced by one edge whose weight is the sum of
+ * their weights (in input order), and dropped if this sum is 0.  The
+ * isolated nodes are removed afterwards, so that the nodes of the edges
+ * that cancel out are removed too.  No hashing is involved and the memory
+ * is twice the one of the edges, so that this scales to very large graphs.
+ *
+ * Options:
+ *   -b: the input graph is in the binary format of edge_io.h.
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       double weights, exactly instead of with 6 significant digits.
+ *   -m: merge the parallel edges, (i,j) and (j,i) included, as above; the
+ *       edges are then written sorted by their end nodes.
+ *   -h: print the usage.
+ *
  * Input Format:
  *   The input is read from standard input (std::cin).
  *   - The first line contains two integers: n (number of nodes) and m (number
@@ -48,106 +70,58 @@
  *
  */
 
-#include <algorithm>  // For standard algorithms (e.g., std::swap)
-#include <iostream>   // For input/output operations (cin, cout)
-#include <limits>     // For numerical limits (e.g., max of streamsize)
-#include <vector>     // For using dynamic arrays (vectors)
+#include <unistd.h>  // For getopt
+
+#include <cstdlib>   // For EXIT_SUCCESS
+#include <iostream>  // For the usage
+
+#include "converters.h"  // For the conversion itself
+#include "edge_io.h"     // For buffered input/output of the edges
 
-using Index = unsigned int;  // Define a type alias 'Index' for unsigned
-                             // integers, representing array indices
 using namespace std;  // Use the standard namespace to avoid having to write
                       // std:: repeatedly
 
-// Function to skip comment lines or lines with only spaces in an input stream.
-// Comments start with '#' and extend to the end of the line.
-void skipComment(istream& f) {
-  char ch;  // Temporary character to hold the read char
-  // Read characters until a non-comment/non-space character is encountered or
-  // the end of the stream is reached.
-  while (f.get(ch) && (ch == '#' || ch == ' ')) {
-    // Ignore all characters until the end of the line.
-    f.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-  }
-  // If a non-comment/non-space character was found, put it back into the
-  // stream.
-  if (f.good()) {
-    f.unget();
-  }
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-b] [-B] [-m] [-h]" << endl;
+  cerr << " -b flag: the input graph is in the binary format" << endl;
+  cerr << " -B flag: the output graph is written in the binary format" << endl;
+  cerr << " -m flag: the parallel edges are merged and those that cancel out "
+       << "are dropped" << endl;
+  cerr << " -h flag: print this message." << endl;
 }
 
-int main() {
-  Index n, m;  // n: number of nodes, m: number of edges
-
-  // read input graph
-  skipComment(std::cin);  // Skip any leading comments or blank lines in the
-                          // standard input
-  std::cin >> n >>
-      m;  // Read the number of nodes (n) and edges (m) from the standard input
-
-  std::vector<Index> degree(
-      n,
-      0);  // Create a vector 'degree' of size 'n', initialized with zeros.
-           // degree[i] will store the degree (number of connections) of node i.
-  std::vector<tuple<Index, Index, double>>
-      edges;  // Store edges as tuples
-              // Each tuple represents an edge: (source node, destination node,
-              // weight)
-
-  edges.reserve(m);  // Pre-allocate space for 'm' edges in the 'edges' vector
-                     // to avoid frequent reallocations
-
-  // Loop through each edge
-  for (Index e = 0; e != m; ++e) {
-    Index f, t;               // f: source node, t: destination node
-    double w;                 // w: weight of the edge
-    std::cin >> f >> t >> w;  // Read the source node, destination node, and
-                              // weight of the current edge
-    if (w != 0) {             // check if w is different than 0
-      edges.emplace_back(
-          f - 1, t - 1,
-          w);  // store the edge, decrementing f and t to 0 based index
-               // Add the edge (f-1, t-1, w) to the 'edges' vector.
-               // emplace_back constructs the tuple directly in the vector,
-               // which is more efficient than push_back.
-      ++degree[f - 1];  // Increment the degree of the source node.
-      ++degree[t - 1];  // Increment the degree of the destination node.
+int main(int argc, char** argv) {
+  bool in_binary = false, out_binary = false;  // formats of the graphs
+  bool merge = false;  // whether the parallel edges are merged
+  int opt;
+  while ((opt = getopt(argc, argv, "bBmh")) != -1) {
+    switch (opt) {
+      case 'b':
+        in_binary = true;
+        break;
+      case 'B':
+        out_binary = true;
+        break;
+      case 'm':
+        merge = true;
+        break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
     }
   }
-
-  vector<Index> name(n);  // Create a vector 'name' of size 'n'.
-                          // 'name' will store the new indices of the nodes
-                          // after removing isolated nodes.
-  Index new_n =
-      0;  // Initialize a counter for the number of non-isolated nodes.
-  // Iterate through each node
-  for (Index k = 0; k != n; ++k) {
-    if (degree[k] >
-        0) {  // Check if the degree of node k is greater than 0 (not isolated).
-      name[k] =
-          new_n++;  // Assign a new index to node k and increment the counter.
-    }
+  if (optind != argc) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
   }
-
-  cout << new_n << " " << edges.size()
-       << std::endl;  // Output the new number of nodes (non-isolated) and the
-                      // number of edges
-
-  // Iterate through each edge in the 'edges' vector.
-  for (const auto& edge : edges) {
-    Index f = name[std::get<0>(
-        edge)];  // Get the source node index from the tuple and use it to get
-                 // its new index from the name array
-    Index t = name[std::get<1>(
-        edge)];  // Get the destination node index from the tuple and use it to
-                 // get its new index from the name array
-    double w = std::get<2>(edge);  // Get the weight from the tuple.
-    if (f > t) {  // Ensure that the source node index is always less than or
-                  // equal to the destination node index.
-      std::swap(f, t);  // Use std::swap for efficiency if f > t.
-    }
-    std::cout << f + 1 << " " << t + 1 << " " << w
-              << std::endl;  // Output the edge (source, destination, weight),
-                             // incrementing f and t to 1 based index
+  try {
+    GraphInput in(in_binary);     // the standard input
+    GraphOutput out(out_binary);  // the standard output
+    deChimera(in, out, merge);
+  } catch (const GraphError& e) {
+    cerr << "Error: " << e.what() << endl;
+    exit(EXIT_FAILURE);
   }
 
   return EXIT_SUCCESS;  // Indicate that the program executed successfully.
@@ -0,0 +1,210 @@
+/**
+ * @file decimal.h
+ * @brief Exact representation of the decimal numbers found in the results
+ * file.
+ *
+ * Objective values and times are written in the results file as decimal
+ * strings (e.g. "1234.5", "1.2345e3") and the statistics require exact
+ * comparisons among them: two values are tied only if they are the same
+ * number, whatever their representation.  A Decimal is parsed once from its
+ * string and holds
+ *   - the significant digits, without leading and trailing zeros, as a 128
+ *     bit integer (up to 38 digits; a number with more significant digits
+ *     is rounded half up to 38 of them, so that values written at full
+ *     precision are still read),
+ *   - the power of ten they are multiplied by,
+ *   - the sign,
+ * so that equal numbers have equal representations and comparisons take a
+ * few integer operations.  It also keeps the double value of the string, as
+ * converted by stod, for the statistics computed in floating point.
+ *
+ * Decimal is trivially copyable and can be stored as such in the binary
+ * cache of the results file.
+**/
+
+#ifndef DECIMAL_H
+#define DECIMAL_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "csv.h"
+
+class Decimal {
+ public:
+  static constexpr int kMaxDigits = 38;
+
+  Decimal() = default;
+
+  // Converts s, which may be surrounded by blanks.  The empty string is
+  // converted to zero; the digits beyond the first kMaxDigits significant
+  // ones are rounded off, half up.  Returns false if s is not a decimal
+  // number.
+  bool parse(std::string_view s) {
+    *this = Decimal();
+    std::size_t i = 0, n = s.size();
+    while (n > 0 && is_blank(s[n - 1])) --n;
+    while (i < n && is_blank(s[i])) ++i;
+    if (i == n) return true;
+    std::string_view text = s.substr(i, n - i);
+
+    bool neg = false;
+    if (s[i] == '+' || s[i] == '-') neg = s[i++] == '-';
+    unsigned __int128 d = 0;
+    int nd = 0;          // significant digits accumulated in d
+    long exp = 0;        // power of ten of the last digit in d
+    int pending = 0;     // zeros read but not yet accumulated
+    long dropped = 0;    // digits read beyond kMaxDigits
+    int round = 0;       // the first of them
+    bool any = false;    // a digit has been read
+    bool point = false;  // the decimal point has been read
+    for (; i < n; ++i) {
+      char c = s[i];
+      if (c == '.' && !point) {
+        point = true;
+        continue;
+      }
+      if (c < '0' || c > '9') break;
+      any = true;
+      if (point) --exp;
+      if (dropped > 0) {
+        ++dropped;
+        continue;
+      }
+      if (c == '0') {
+        if (nd > 0) ++pending;  // leading zeros are not significant
+        continue;
+      }
+      if (nd + pending + 1 > kMaxDigits) {
+        // the zeros that fit are accumulated, the other digits dropped
+        for (; nd < kMaxDigits; --pending, ++nd) d *= 10;
+        round = pending > 0 ? 0 : c - '0';
+        dropped = pending + 1;
+        pending = 0;
+        continue;
+      }
+      for (; pending > 0; --pending, ++nd) d *= 10;
+      d = d * 10 + (c - '0');
+      ++nd;
+    }
+    // trailing zeros and dropped digits are moved into the exponent
+    exp += pending + dropped;
+    if (!any) return false;
+    if (round >= 5) {
+      ++d;
+      if (d == pow10(nd)) ++nd;  // e.g. 99...9 rounded up to 100...0
+    }
+    for (; d != 0 && d % 10 == 0; d /= 10, --nd) ++exp;
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+      ++i;
+      bool eneg = false;
+      if (i < n && (s[i] == '+' || s[i] == '-')) eneg = s[i++] == '-';
+      if (i == n) return false;
+      long e = 0;
+      for (; i < n && s[i] >= '0' && s[i] <= '9'; ++i)
+        if (e < 1000000) e = e * 10 + (s[i] - '0');
+      exp += eneg ? -e : e;
+    }
+    if (i != n) return false;
+
+    if (nd > 0) {
+      digits = d;
+      ndigits = nd;
+      exponent = static_cast<std::int32_t>(exp);
+      negative = neg;
+    }
+    // numbers out of the range of double, where from_chars fails, are
+    // rounded by strtod to infinity or zero
+    if (!parse_number(text, approx))
+      approx = std::strtod(std::string(text).c_str(), nullptr);
+    return true;
+  }
+
+  // The double value of the string, as converted by stod.
+  double to_double() const { return approx; }
+
+  // The exact decimal string of the number, without exponent unless it
+  // would need more than kMaxDigits zeros, e.g. "-12.5", "0.001", "3e75".
+  // parse gives back the same number.
+  std::string to_string() const {
+    if (digits == 0) return "0";
+    std::string s;
+    for (unsigned __int128 d = digits; d != 0; d /= 10)
+      s.insert(s.begin(), static_cast<char>('0' + static_cast<int>(d % 10)));
+    if (exponent >= 0 && exponent <= kMaxDigits) {
+      s.append(exponent, '0');
+    } else if (exponent < 0 && -exponent < ndigits) {
+      s.insert(s.end() + exponent, '.');
+    } else if (exponent < 0 && -exponent - ndigits <= kMaxDigits) {
+      s.insert(0, std::string(-exponent - ndigits, '0'));
+      s.insert(0, "0.");
+    } else {
+      s += 'e' + std::to_string(exponent);
+    }
+    return negative ? '-' + s : s;
+  }
+
+  // Returns 1, 0, -1 if a is greater than, equal to, less than b.
+  friend int compare(const Decimal& a, const Decimal& b) {
+    if (a.negative != b.negative) return a.negative ? -1 : 1;
+    int m = compare_magnitude(a, b);
+    return a.negative ? -m : m;
+  }
+
+  friend bool operator==(const Decimal& a, const Decimal& b) {
+    return a.digits == b.digits && a.exponent == b.exponent &&
+           a.negative == b.negative;
+  }
+  friend bool operator!=(const Decimal& a, const Decimal& b) {
+    return !(a == b);
+  }
+  friend bool operator<(const Decimal& a, const Decimal& b) {
+    return compare(a, b) < 0;
+  }
+  friend bool operator>(const Decimal& a, const Decimal& b) {
+    return compare(a, b) > 0;
+  }
+
+ private:
+  unsigned __int128 digits = 0;  // significant digits (0 for zero)
+  double approx = 0.0;           // value converted by stod
+  std::int32_t exponent = 0;     // the number is digits * 10^exponent
+  std::int16_t ndigits = 0;      // number of decimal digits of digits
+  bool negative = false;         // zero is never negative
+  char padding = 0;  // explicit, so that the bytes of a Decimal are defined
+
+  static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  static unsigned __int128 pow10(int k) {
+    unsigned __int128 p = 1;
+    while (k-- > 0) p *= 10;
+    return p;
+  }
+
+  static int compare_magnitude(const Decimal& a, const Decimal& b) {
+    if (a.digits == 0 || b.digits == 0)
+      return (a.digits != 0) - (b.digits != 0);
+    // position of the most significant digit
+    long la = static_cast<long>(a.ndigits) + a.exponent;
+    long lb = static_cast<long>(b.ndigits) + b.exponent;
+    if (la != lb) return la < lb ? -1 : 1;
+    if (a.exponent == b.exponent) return (a.digits > b.digits) - (a.digits < b.digits);
+    // same most significant digit: compare the digits left aligned
+    unsigned __int128 x = a.digits, y = b.digits;
+    if (a.ndigits < b.ndigits)
+      x *= pow10(b.ndigits - a.ndigits);
+    else
+      y *= pow10(a.ndigits - b.ndigits);
+    return (x > y) - (x < y);
+  }
+};
+
+static_assert(std::is_trivially_copyable<Decimal>::value,
+              "Decimal is stored as such in the binary cache");
+
+#endif  // DECIMAL_H
@@ -0,0 +1,456 @@
+/**
+ * @file edge_io.h
+ * @brief Buffered reading and writing of the edge lists of the graph
+ * converters.
+ *
+ * The converters read a graph as a sequence of whitespace-separated numbers
+ * (a header with the number of nodes and of edges, then one line per edge)
+ * and write it back in the same form.  Graphs may have millions of edges,
+ * so
+ *   - EdgeReader reads its file descriptor in large blocks and converts the
+ *     numbers in place with std::from_chars;
+ *   - EdgeWriter formats the numbers with std::to_chars into a large buffer,
+ *     which is written when full and at the end, never at every line.
+ * Both use constant memory, whatever the size of the graph.  Numbers are
+ * read and written as operator>> and operator<< of the standard streams do
+ * with their default settings (doubles are written with 6 significant
+ * digits), so that the outputs are the same as with std::cin and std::cout.
+ *
+ * Graphs can also be read and written in a binary format (options -b and -B
+ * of the converters, see GraphInput and GraphOutput), which is read and
+ * written without any conversion of the numbers:
+ *   - a BinaryGraphHeader: magic "MCGRAPH", version, byte order marker,
+ *     the number of nodes n and of edges m, the type of the weights (double
+ *     or int64) and flags;
+ *   - m BinaryEdge records of 16 bytes: the two end nodes, as uint32 and as
+ *     numbered in the text format, and the weight, exactly;
+ *   - if flag kGraphHasCSR is set, n + 1 uint64 offsets: the edges are
+ *     sorted by their first end node and those of node v (1-based) are
+ *     records off[v - 1], ..., off[v] - 1.
+ * All integers are in native byte order and the records are 8-byte
+ * aligned, so that a graph file can be mapped in memory and used in place.
+ *
+ * The errors, an invalid input or an output that cannot be written, throw a
+ * GraphError: the converters print its message and exit, graphbatch fails
+ * the conversion of the file only.
+**/
+
+#ifndef EDGE_IO_H
+#define EDGE_IO_H
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+//-------------------------------------------------------------------
+// An invalid input graph or an output that cannot be written.
+class GraphError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+//-------------------------------------------------------------------
+class EdgeReader {
+ public:
+  explicit EdgeReader(int fd = STDIN_FILENO, std::size_t capacity = 1 << 20)
+      : fd(fd), buf(capacity) {}
+
+  // Skips the lines starting with comment or with a blank, as the
+  // skipComment functions of the converters did on std::cin.
+  void skip_comments(char comment) {
+    while (available() && (buf[pos] == comment || buf[pos] == ' ')) {
+      while (available() && buf[pos] != '\n') ++pos;
+      if (available()) ++pos;
+    }
+  }
+
+  // Reads the next numbers of the input.  Throws a GraphError if the input
+  // ends or a field is not a number of the right type.
+  template <class... T>
+  void read(T&... values) {
+    (read_number(values), ...);
+  }
+
+  // Reads n bytes into data.  Returns false if the input ends before.
+  bool read_bytes(void* data, std::size_t n) {
+    char* p = static_cast<char*>(data);
+    while (n > 0) {
+      if (!available()) return false;
+      std::size_t k = std::min(n, end - pos);
+      std::memcpy(p, buf.data() + pos, k);
+      pos += k;
+      p += k;
+      n -= k;
+    }
+    return true;
+  }
+
+  // Reads the rest of the current line, without its end.  Returns false at
+  // the end of the input.
+  bool getline(std::string& line) {
+    if (!available()) return false;
+    line.clear();
+    while (available() && buf[pos] != '\n') line += buf[pos++];
+    if (available()) ++pos;
+    return true;
+  }
+
+ private:
+  int fd;
+  std::vector<char> buf;
+  std::size_t pos = 0, end = 0;  // unread characters are buf[pos, end)
+  bool eof = false;
+
+  static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+           c == '\v';
+  }
+
+  // Moves the unread characters to the beginning of the buffer, enlarging
+  // it if they fill it, and reads more.  Returns false if no character
+  // could be read.
+  bool fill() {
+    if (eof) return false;
+    std::memmove(buf.data(), buf.data() + pos, end - pos);
+    end -= pos;
+    pos = 0;
+    if (end == buf.size()) buf.resize(2 * buf.size());
+    ssize_t n;
+    do {
+      n = ::read(fd, buf.data() + end, buf.size() - end);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+      eof = true;
+      return false;
+    }
+    end += n;
+    return true;
+  }
+
+  // Whether a character is available at buf[pos].
+  bool available() { return pos < end || fill(); }
+
+  void skip_blanks() {
+    while (available() && is_blank(buf[pos])) ++pos;
+  }
+
+  // The next whitespace-separated field, empty at the end of the input.
+  std::string_view field() {
+    skip_blanks();
+    std::size_t len = 0;
+    for (;;) {
+      while (pos + len < end && !is_blank(buf[pos + len])) ++len;
+      if (pos + len < end || !fill()) break;
+    }
+    std::string_view f(buf.data() + pos, len);
+    pos += len;
+    return f;
+  }
+
+  template <class T>
+  void read_number(T& value) {
+    std::string_view f = field();
+    if (f.empty()) throw GraphError("unexpected end of input");
+    std::string_view digits = f;
+    if (digits.size() > 1 && digits[0] == '+' && digits[1] != '-')
+      digits.remove_prefix(1);
+    std::from_chars_result res =
+        std::from_chars(digits.data(), digits.data() + digits.size(), value);
+    if (res.ec != std::errc() || res.ptr != digits.data() + digits.size())
+      throw GraphError("invalid number " + std::string(f));
+  }
+};
+
+//-------------------------------------------------------------------
+class EdgeWriter {
+ public:
+  explicit EdgeWriter(int fd = STDOUT_FILENO, std::size_t capacity = 1 << 20)
+      : fd(fd), buf(capacity) {}
+  EdgeWriter(const EdgeWriter&) = delete;
+  EdgeWriter& operator=(const EdgeWriter&) = delete;
+  // Writes the buffer, unless an error is being thrown: the output is then
+  // incomplete anyway.
+  ~EdgeWriter() noexcept(false) {
+    if (std::uncaught_exceptions() == 0) flush();
+  }
+
+  EdgeWriter& operator<<(char c) {
+    reserve(1);
+    buf[end++] = c;
+    return *this;
+  }
+  EdgeWriter& operator<<(std::string_view s) {
+    if (s.size() > buf.size()) {
+      flush();
+      write_all(s.data(), s.size());
+      return *this;
+    }
+    reserve(s.size());
+    std::memcpy(buf.data() + end, s.data(), s.size());
+    end += s.size();
+    return *this;
+  }
+  // Writes n bytes as they are.
+  void write_bytes(const void* data, std::size_t n) {
+    *this << std::string_view(static_cast<const char*>(data), n);
+  }
+  EdgeWriter& operator<<(const char* s) {
+    return *this << std::string_view(s);
+  }
+  template <class T,
+            class = std::enable_if_t<std::is_integral<T>::value &&
+                                     !std::is_same<T, char>::value>>
+  EdgeWriter& operator<<(T value) {
+    reserve(kMaxNumber);
+    end = std::to_chars(buf.data() + end, buf.data() + buf.size(), value).ptr -
+          buf.data();
+    return *this;
+  }
+  EdgeWriter& operator<<(double value) {
+    reserve(kMaxNumber);
+    end = std::to_chars(buf.data() + end, buf.data() + buf.size(), value,
+                        std::chars_format::general, 6)
+              .ptr -
+          buf.data();
+    return *this;
+  }
+
+  // Writes the buffer.  Throws a GraphError if this fails.
+  void flush() {
+    write_all(buf.data(), end);
+    end = 0;
+  }
+
+ private:
+  // room for any number written by operator<<
+  static constexpr std::size_t kMaxNumber = 64;
+
+  int fd;
+  std::vector<char> buf;
+  std::size_t end = 0;  // the characters to be written are buf[0, end)
+
+  void reserve(std::size_t n) {
+    if (buf.size() - end < n) flush();
+  }
+
+  void write_all(const char* data, std::size_t n) {
+    while (n > 0) {
+      ssize_t k = ::write(fd, data, n);
+      if (k < 0 && errno == EINTR) continue;
+      if (k <= 0) throw GraphError("cannot write the output");
+      data += k;
+      n -= k;
+    }
+  }
+};
+
+//-------------------------------------------------------------------
+// binary graph format
+
+enum GraphWeightType : std::uint32_t { kWeightDouble = 0, kWeightInt64 = 1 };
+constexpr std::uint32_t kGraphHasCSR = 1;  // flag of BinaryGraphHeader
+
+struct BinaryGraphHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t endian;
+  std::uint64_t n;
+  std::uint64_t m;
+  std::uint32_t weight_type;
+  std::uint32_t flags;
+};
+
+struct BinaryEdge {
+  std::uint32_t fr;
+  std::uint32_t to;
+  std::int64_t weight;  // the bits of a double or an int64
+};
+
+constexpr char kGraphMagic[8] = {'M', 'C', 'G', 'R', 'A', 'P', 'H', '\0'};
+constexpr std::uint32_t kGraphVersion = 1;
+constexpr std::uint32_t kGraphEndian = 0x01020304;
+
+static_assert(sizeof(BinaryGraphHeader) == 40 && sizeof(BinaryEdge) == 16,
+              "the binary graph format has no padding");
+
+//-------------------------------------------------------------------
+// Reads a graph, made of a header with the number of nodes and of edges and
+// of the edges, from a file descriptor in the text or in the binary format.
+class GraphInput {
+ public:
+  explicit GraphInput(bool binary, int fd = STDIN_FILENO)
+      : binary(binary), in(fd) {}
+
+  // Skips the comments before the header of a text graph.
+  void skip_comments(char comment) {
+    if (!binary) in.skip_comments(comment);
+  }
+
+  template <class N, class M>
+  void read_header(N& n, M& m) {
+    if (!binary) {
+      in.read(n, m);
+      return;
+    }
+    if (!in.read_bytes(&header, sizeof(header)) ||
+        std::memcmp(header.magic, kGraphMagic, sizeof(kGraphMagic)) != 0 ||
+        header.version != kGraphVersion || header.endian != kGraphEndian ||
+        header.weight_type > kWeightInt64)
+      throw GraphError("the input is not a binary graph");
+    n = static_cast<N>(header.n);
+    m = static_cast<M>(header.m);
+  }
+
+  // The type of the weights: always double in the text format.
+  GraphWeightType weight_type() const {
+    return binary ? static_cast<GraphWeightType>(header.weight_type)
+                  : kWeightDouble;
+  }
+
+  template <class T, class W>
+  void read_edge(T& fr, T& to, W& w) {
+    if (!binary) {
+      in.read(fr, to, w);
+      return;
+    }
+    BinaryEdge e;
+    if (!in.read_bytes(&e, sizeof(e)))
+      throw GraphError("unexpected end of input");
+    fr = static_cast<T>(e.fr);
+    to = static_cast<T>(e.to);
+    if (header.weight_type == kWeightInt64) {
+      w = static_cast<W>(e.weight);
+    } else {
+      double d;
+      std::memcpy(&d, &e.weight, sizeof(d));
+      w = static_cast<W>(d);
+    }
+  }
+
+  // Raw access, e.g. to read a text input of another format.
+  EdgeReader& reader() { return in; }
+
+ private:
+  bool binary;
+  EdgeReader in;
+  BinaryGraphHeader header{};
+};
+
+//-------------------------------------------------------------------
+// Writes a graph in the text or in the binary format.  In the text format
+// the weights are written as operator<< does for their C++ type; in the
+// binary format they are converted to the type given in the header.
+class GraphOutput {
+ public:
+  explicit GraphOutput(bool binary, int fd = STDOUT_FILENO)
+      : binary(binary), out(fd) {}
+
+  void write_header(std::uint64_t n, std::uint64_t m,
+                    GraphWeightType type = kWeightDouble,
+                    std::uint32_t flags = 0) {
+    if (!binary) {
+      out << n << ' ' << m << '\n';
+      return;
+    }
+    if (n > UINT32_MAX)
+      throw GraphError(std::to_string(n) +
+                       " nodes do not fit in the binary format");
+    BinaryGraphHeader h{};
+    std::memcpy(h.magic, kGraphMagic, sizeof(kGraphMagic));
+    h.version = kGraphVersion;
+    h.endian = kGraphEndian;
+    h.n = n;
+    h.m = m;
+    h.weight_type = weight_type = type;
+    h.flags = flags;
+    out.write_bytes(&h, sizeof(h));
+  }
+
+  // In the binary format, throws a GraphError if an end node does not fit
+  // in a uint32 or, with int64 weights, if w is not an integer.
+  template <class W>
+  void write_edge(std::uint64_t fr, std::uint64_t to, W w) {
+    if (!binary) {
+      out << fr << ' ' << to << ' ' << w << '\n';
+      return;
+    }
+    if (fr > UINT32_MAX || to > UINT32_MAX)
+      throw GraphError("node out of range of the binary format in edge " +
+                       std::to_string(fr) + " " + std::to_string(to));
+    BinaryEdge e{static_cast<std::uint32_t>(fr), static_cast<std::uint32_t>(to),
+                 0};
+    if (weight_type == kWeightInt64) {
+      if constexpr (std::is_floating_point<W>::value) {
+        // the doubles in [-2^63, 2^63) convert exactly
+        if (!(w >= -0x1p63 && w < 0x1p63) || std::trunc(w) != w)
+          throw GraphError("weight " + std::to_string(w) +
+                           " is not an int64 of the binary format");
+      }
+      e.weight = static_cast<std::int64_t>(w);
+    } else {
+      double d = static_cast<double>(w);
+      std::memcpy(&e.weight, &d, sizeof(d));
+    }
+    out.write_bytes(&e, sizeof(e));
+  }
+
+  // Raw access, e.g. to the CSR section of a binary graph.
+  EdgeWriter& writer() { return out; }
+
+ private:
+  bool binary;
+  EdgeWriter out;
+  GraphWeightType weight_type = kWeightDouble;
+};
+
+//-------------------------------------------------------------------
+// Parses the options of a converter selecting the format of its input (-b,
+// if binary_input is allowed) and of its output (-B).  Prints the usage
+// and exits on -h or on any other option; the arguments that are not
+// options are left from optind on.
+inline void parse_format_options(int argc, char** argv, bool binary_input,
+                                 bool& in_binary, bool& out_binary,
+                                 const char* arguments = "") {
+  in_binary = out_binary = false;
+  int opt;
+  bool print_help = false;
+  while ((opt = getopt(argc, argv, binary_input ? "bBh" : "Bh")) != -1) {
+    switch (opt) {
+      case 'b':
+        in_binary = true;
+        break;
+      case 'B':
+        out_binary = true;
+        break;
+      case 'h':
+      default:
+        print_help = true;
+    }
+  }
+  if (!print_help) return;
+  std::cerr << "Usage: " << argv[0] << (binary_input ? " [-b]" : "")
+            << " [-B] [-h]" << arguments << std::endl;
+  if (binary_input)
+    std::cerr << " -b flag: the input graph is in the binary format" << std::endl;
+  std::cerr << " -B flag: the output graph is written in the binary format"
+            << std::endl;
+  std::cerr << " -h flag: print this message." << std::endl;
+  std::exit(EXIT_FAILURE);
+}
+
+#endif  // EDGE_IO_H
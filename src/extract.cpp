@@ -16,33 +16,50 @@
  * Additionally, the program prints a summary to the standard output, indicating the number of
  * extracted instances and the range of their sizes (in terms of the number of nodes).
  *
- * The program uses helper functions `trim` and `split` to process strings efficiently.
+ * The summary file is loaded through a SummaryIndex (see summary_index.h):
+ * with -b it is compiled into a binary, columnar index "<summary_file>.idx",
+ * which later invocations map in memory instead of parsing the summary file,
+ * as long as it is fresh.  Besides -d and -n, instances can be filtered by a
+ * predicate over all the columns of the summary file (e.g.
+ * "n >= 100 && n <= 1000 && toroidal == 0"), evaluated column-wise on all
+ * instances at once; a batch of queries, each with its own output file, can
+ * be run in a single invocation with -q.  The filters -i, -d and -n apply to
+ * all queries.
  *
  * Usage:
- *   ./extract -s <summary_file> -o <output_file> [-i <interesting_file>] [-d <max_density_perc>] [-n <min_negative_perc>] [-h]
+ *   ./extract -s <summary_file> -o <output_file> [-i <interesting_file>] [-d <max_density_perc>] [-n <min_negative_perc>]
+ *             [-p <predicate>] [-q <queries_file>] [-b] [-h]
  *
  *   -s <summary_file>       [mandatory] The path to the summary file.
- *   -o <output_file>        [mandatory] The path to the output file where extracted instance names will be written.
+ *   -o <output_file>        [mandatory unless -q or -b] The path to the output file where extracted instance names will be written.
  *   -i <interesting_file>   [optional]  The path to a file containing a list of interesting instance names.
  *   -d <max_density_perc>   [optional]  The maximum density percentage (0.0 - 100.0) of instances to extract.
  *   -n <min_negative_perc>  [optional]  The minimum percentage (0.0 - 100.0) of negative edges in instances to extract.
+ *   -p <predicate>          [optional]  A predicate the instances written to <output_file> must satisfy.
+ *   -q <queries_file>       [optional]  A file of queries, one per line: an output file and a predicate, separated by
+ *                                       blanks; lines starting with '#' are comments.  For every query, the instances
+ *                                       satisfying the predicate are written to its output file.
+ *   -b                      [optional]  Compiles the summary file into its binary index.
  *   -h                      [optional]  Prints this help message.
  *
+ * Predicates are made of the column names, numbers, + - * /, the comparisons < <= > >= == != and ! && || with the
+ * precedence of C++ and parentheses, e.g. "density < 0.5 && (n_neg > 10 || interesting == 1)".
+ *
  * Example summary file format (comma-separated values):
- *   name,n,m,density,mean_deg,sd_deg,n_neg,n_zero,n_pos,max_precision,mean_w,sd_w
- *   instance1,10,45,1.0,9,0,100.0,0.0,0.0,10,1.0,0.0
- *   instance2,20,100,0.5,10,2,50.0,25.0,25.0,20,0.5,0.2
+ *   name,n,m,density,max_deg,mean_deg,sd_deg,n_neg,n_zero,n_pos,max_precision,mean_w,sd_w,interesting,toroidal
+ *   instance1,10,45,1.0,9,9,0,100.0,0.0,0.0,10,1.0,0.0,1,0
+ *   instance2,20,100,0.5,14,10,2,50.0,25.0,25.0,20,0.5,0.2,0,1
  *   ...
  */
 #include <unistd.h>
 
 #include <fstream>
 #include <iostream>
-#include <limits>
 #include <string>
-#include <unordered_set>
 #include <utility>
-#include <vector>  // Added for string splitting
+#include <vector>
+
+#include "summary_index.h"
 
 using namespace std;
 using Index = unsigned int;
@@ -60,37 +77,54 @@ string trim(const string& str) {
   return str.substr(first, (last - first + 1));
 }
 
-// Function to split a string into tokens using a delimiter.
-vector<string> split(const string& s, const string& delimiter) {
-  vector<string> tokens;
-  size_t start = 0;
-  size_t end = s.find(delimiter);
-  while (end != string::npos) {
-    tokens.push_back(s.substr(start, end - start));
-    start = end + delimiter.length();
-    end = s.find(delimiter, start);
+// A query: the instances satisfying predicate (all if it is empty) are
+// written to file output.
+struct Query {
+  string output;
+  string predicate;
+};
+
+// Reads the queries of a queries file, one per line.
+vector<Query> read_queries(const char* queries_name) {
+  ifstream qf(queries_name);
+  if (!qf.is_open()) {
+    cerr << "Error: File " << queries_name << " does not exist!" << endl
+         << endl;
+    exit(EXIT_FAILURE);
+  }
+  vector<Query> queries;
+  string line;
+  while (getline(qf, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    line = trim(line);
+    if (line.empty() || line[0] == '#') continue;  // skip comment lines
+    size_t sep = line.find_first_of(" \t");
+    Query q;
+    q.output = line.substr(0, sep);
+    if (sep != string::npos) q.predicate = trim(line.substr(sep + 1));
+    queries.push_back(q);
   }
-  tokens.push_back(s.substr(start));  // Add the last token
-  for (Index i = 0; i != tokens.size(); ++i)
-    if (tokens[i] == "") tokens[i] = "0";
-  return tokens;
+  return queries;
 }
 
 int main(int argc, char* argv[]) {
   // Read the parameters
   int opt;
   bool print_help = false;
+  bool compile = false;
   double max_density_perc = 100.0;
   double min_negative_perc = 0.0;
   char* sum_name = nullptr;
   char* out_name = nullptr;
   char* intr_name = nullptr;
+  char* pred_text = nullptr;
+  char* queries_name = nullptr;
 
   cerr << endl;
   if (argc == 1) {
     print_help = true;
   } else {
-    while ((opt = getopt(argc, argv, "s:o:i:d:n:h")) != -1) {
+    while ((opt = getopt(argc, argv, "s:o:i:d:n:p:q:bh")) != -1) {
       switch (opt) {
         case 's':
           sum_name = optarg;
@@ -107,6 +141,15 @@ int main(int argc, char* argv[]) {
         case 'n':
           min_negative_perc = stod(optarg);
           break;
+        case 'p':
+          pred_text = optarg;
+          break;
+        case 'q':
+          queries_name = optarg;
+          break;
+        case 'b':
+          compile = true;
+          break;
         case 'h':
         default:
           print_help = true;
@@ -115,17 +158,24 @@ int main(int argc, char* argv[]) {
   }
 
   // Parameter Validation and Help Message
+  bool querying = out_name != nullptr || queries_name != nullptr;
   if (!print_help) {
     if (sum_name == nullptr) {
       cerr << "Error: Parameter -s <input_file> is mandatory" << endl;
       print_help = true;
     }
 
-    if (out_name == nullptr) {
+    if (!querying && !compile) {
       cerr << "Error: Parameter -o <outut_file> is mandatory" << endl;
       print_help = true;
     }
 
+    if (pred_text != nullptr && out_name == nullptr) {
+      cerr << "Error: Parameter -p <predicate> requires -o <output_file>"
+           << endl;
+      print_help = true;
+    }
+
     if (max_density_perc < 0 || max_density_perc > 100.0) {
       cerr << "Error: Illegal value of <max_density_percentage>" << endl;
       print_help = true;
@@ -136,9 +186,10 @@ int main(int argc, char* argv[]) {
       print_help = true;
     }
 
-    if (min_negative_perc == 0.0 && max_density_perc == 100.0) {
-      cerr << "Error: At least one of the two parameters -d and -n must be set"
-           << endl;
+    if (querying && min_negative_perc == 0.0 && max_density_perc == 100.0 &&
+        pred_text == nullptr && queries_name == nullptr) {
+      cerr << "Error: At least one of the parameters -d, -n, -p and -q must "
+           << "be set" << endl;
       print_help = true;
     }
   }
@@ -148,11 +199,13 @@ int main(int argc, char* argv[]) {
          << "-o <output_file> [-i <interesting_file>]" << endl;
     cerr << string(tmp.length() + 8, ' ') << "[-d <max_density_perc>] "
          << "[-n <min_negative_perc>] "
+         << "[-p <predicate>]" << endl;
+    cerr << string(tmp.length() + 8, ' ') << "[-q <queries_file>] [-b] "
          << "[-h]" << endl
          << endl;
     cerr << " -s <summary_file> [mandatory]" << endl;
     cerr << " -o <output_file> the names of the extracted instances "
-         << "[mandatory]" << endl;
+         << "[mandatory unless -q or -b]" << endl;
     cerr << " -i <interesting_file> the names of the interesting instances "
          << "[default: all]" << endl;
     cerr << " -d <max_density_perc> (>=0 and <= 100.0): max density "
@@ -161,41 +214,72 @@ int main(int argc, char* argv[]) {
     cerr << " -n <min_negative_perc>: (>=0 and <= 100.0) minimum "
          << "percentage " << endl;
     cerr << "    of negative edges of the instances to be extracted." << endl;
+    cerr << " -p <predicate>: predicate over the columns of the summary file "
+         << "that the" << endl;
+    cerr << "    instances written to <output_file> must satisfy, e.g. "
+         << "\"n >= 100 && toroidal == 0\"" << endl;
+    cerr << " -q <queries_file>: a query per line, made of an output file "
+         << "and a predicate;" << endl;
+    cerr << "    the instances satisfying the predicate are written to the "
+         << "output file." << endl;
+    cerr << "    -i, -d and -n apply to all queries." << endl;
+    cerr << " -b [flag]: compile the summary file into the binary index "
+         << "<summary_file>.idx," << endl;
+    cerr << "    used instead of the summary file as long as the latter is "
+         << "not modified." << endl;
     cerr << " -h [flag]: print this message." << endl;
     cerr << endl;
     exit(EXIT_FAILURE);
   }
 
-  // File Handling and Error Checks
-  ifstream sumf(sum_name);
-  if (!sumf.is_open()) {
-    cerr << "Error: File " << sum_name << " does not exist!" << endl << endl;
-    exit(EXIT_FAILURE);
-  }
-
-  ifstream intrf;
-  if (intr_name != nullptr) {
-    intrf.open(intr_name);
-    if (!intrf.is_open()) {
-      cerr << "Error: File " << intr_name << " does not exist!" << endl << endl;
+  // Loading the summary file, from its binary index if it is fresh
+  SummaryIndex index;
+  string index_name = SummaryIndex::index_name(sum_name);
+  if (compile || !index.map_index(index_name, sum_name)) {
+    if (!index.parse(sum_name)) {
+      cerr << "Error: File " << sum_name << " does not exist!" << endl << endl;
       exit(EXIT_FAILURE);
     }
+    if (compile) {
+      if (!index.write_index(index_name, sum_name)) {
+        cerr << "Error: Cannot create file " << index_name << "!" << endl
+             << endl;
+        exit(EXIT_FAILURE);
+      }
+      cout << "Compiled " << index.size() << " instances of " << sum_name
+           << " into " << index_name << endl;
+    }
   }
 
-  ofstream outf(out_name);
-  if (!outf.is_open()) {
-    cerr << "Error: Cannot create file " << out_name << "!" << endl << endl;
-    exit(EXIT_FAILURE);
+  // Queries
+  vector<Query> queries;
+  if (out_name != nullptr)
+    queries.push_back({out_name, pred_text == nullptr ? "" : pred_text});
+  if (queries_name != nullptr) {
+    vector<Query> more = read_queries(queries_name);
+    queries.insert(queries.end(), more.begin(), more.end());
+  }
+  vector<SummaryPredicate> predicates(queries.size());
+  for (size_t q = 0; q != queries.size(); ++q) {
+    string error;
+    if (!queries[q].predicate.empty() &&
+        !predicates[q].compile(queries[q].predicate, error)) {
+      cerr << "Error: Invalid predicate \"" << queries[q].predicate
+           << "\": " << error << endl
+           << endl;
+      exit(EXIT_FAILURE);
+    }
   }
-
-  // Data Structures Initialization
-  Index n_extract = 0;
-  unordered_set<string> Inst_names;
-  string line;
-  const string delimeter = ",";
 
   // Read Interesting Instance Names (if provided)
+  StringInterner Inst_names;
+  string line;
   if (intr_name != nullptr) {
+    ifstream intrf(intr_name);
+    if (!intrf.is_open()) {
+      cerr << "Error: File " << intr_name << " does not exist!" << endl << endl;
+      exit(EXIT_FAILURE);
+    }
     while (getline(intrf, line)) {
       line = trim(line);
       if (line.empty() || line[0] == '#') continue;  // skip comment lines
@@ -203,56 +287,55 @@ int main(int argc, char* argv[]) {
       if (!line.empty() && line.back() == '\r') {
         line.pop_back();
       }
-      Inst_names.insert(line);
+      Inst_names.intern(line);
     }
     intrf.close();
   }
 
-  sumf.ignore(numeric_limits<streamsize>::max(), '\n');  // skip header line
-
-  bool first_time = true;
-  Index min_nodes = 0;
-  Index max_nodes = 0;
-
-  // Main Processing Loop: Reading the Summary File
-  while (getline(sumf, line)) {
-    // Split the line into tokens
-    vector<string> tokens = split(line, delimeter);
-
-    // Error checking for the number of tokens
-    if (tokens.size() < 15) {
-      cerr << "Error: Invalid line format: " << line << endl;
-      continue;  // skip to next line
-    }
-
-    // Extracting values from tokens (more readable)
-    string name = tokens[0];
-    Index n = stoi(tokens[1]);
-    Index m = stoi(tokens[2]);
-    double density = stod(tokens[3]);
-    Index max_deg = stoi(tokens[4]);
-    Index mean_deg = stoi(tokens[5]);
-    Index sd_deg = stoi(tokens[6]);
-    double n_neg = stod(tokens[7]);
-    double n_zero = stod(tokens[8]);
-    double n_pos = stod(tokens[9]);
-    Index max_precision = stoi(tokens[10]);
-    double mean_w = stod(tokens[11]);
-    double sd_w = stod(tokens[12]);
-    Index interesting = stoi(tokens[13]);
-    Index toroidal = stoi(tokens[14]);
+  // The filters -i, -d and -n, common to all queries
+  const Index N = index.size();
+  const ArrayView<double>& col_n = index.columns[SummaryIndex::kN];
+  const ArrayView<double>& col_m = index.columns[SummaryIndex::kM];
+  const ArrayView<double>& col_neg = index.columns[SummaryIndex::kNNeg];
+  vector<bool> common(N);
+  for (Index k = 0; k != N; ++k) {
+    Index n = static_cast<Index>(col_n[k]);
+    Index m = static_cast<Index>(col_m[k]);
+    double n_neg = col_neg[k];
 
     // Calculate Thresholds
     Index max_edges = static_cast<Index>(
         (static_cast<double>(n) * (n - 1) / 2) * max_density_perc / 100.0);
     Index neg_edges = static_cast<Index>(m * n_neg / 100.0 + 0.5);
-    Index zero_edges = static_cast<Index>(m * n_zero / 100.0 + 0.5);
     Index target = static_cast<Index>(m * min_negative_perc / 100.0 + 0.5);
 
-    // Filtering and Extraction
-    if (m <= max_edges && neg_edges >= target &&
-        (intr_name == nullptr || Inst_names.find(name) != Inst_names.end())) {
-      outf << name << endl;
+    common[k] = m <= max_edges && neg_edges >= target &&
+                (intr_name == nullptr ||
+                 Inst_names.find(index.names[k]) != StringInterner::kNone);
+  }
+
+  // Filtering and Extraction, query by query
+  vector<bool> selected;
+  for (size_t q = 0; q != queries.size(); ++q) {
+    ofstream outf(queries[q].output);
+    if (!outf.is_open()) {
+      cerr << "Error: Cannot create file " << queries[q].output << "!" << endl
+           << endl;
+      exit(EXIT_FAILURE);
+    }
+    if (queries[q].predicate.empty())
+      selected.assign(N, true);
+    else
+      predicates[q].evaluate(index, selected);
+
+    Index n_extract = 0;
+    bool first_time = true;
+    Index min_nodes = 0;
+    Index max_nodes = 0;
+    for (Index k = 0; k != N; ++k) {
+      if (!common[k] || !selected[k]) continue;
+      Index n = static_cast<Index>(col_n[k]);
+      outf << index.names[k] << '\n';
       ++n_extract;
       if (first_time) {
         min_nodes = n;
@@ -263,15 +346,13 @@ int main(int argc, char* argv[]) {
         max_nodes = max(max_nodes, n);
       }
     }
-  }
+    outf.close();
 
-  // Closing Files
-  outf.close();
-  sumf.close();
-
-  // Output Summary
-  cout << "Extracted " << n_extract << " instances with sizes between "
-       << min_nodes << " and " << max_nodes << " nodes." << endl
-       << endl;
+    // Output Summary
+    if (queries.size() > 1) cout << queries[q].output << ": ";
+    cout << "Extracted " << n_extract << " instances with sizes between "
+         << min_nodes << " and " << max_nodes << " nodes." << endl
+         << endl;
+  }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,303 @@
+/**
+ * @file graphbatch.cpp
+ * @brief This program converts a whole library of instances, as a shell loop
+ * over Qubo2mc, deChimera, netRep2mc and qplib2mc would, in a single
+ * process and in parallel.
+ *
+ * Usage: graphbatch [-t <threads>] [-h] [<manifest>]
+ *
+ * The manifest, read from the file given or, if none, from standard input,
+ * has one line per file to convert:
+ *   <converter> [<flag> ...] <input> <output>
+ * where the converter is one of
+ *   - qubo2mc: as Qubo2mc, with its flags -b, -B, -c and -m;
+ *   - dechimera: as deChimera, with its flags -b, -B and -m;
+ *   - netrep2mc: as netRep2mc, with its flag -B;
+ *   - qplib2mc: as qplib2mc, with its flag -B;
+ * and the graph read from file <input> is written to file <output>, the
+ * same, byte for byte, as the one of the converter (the conversions are
+ * the ones of converters.h); for qplib2mc the output is the file named in
+ * the manifest instead of the one named after the instance.  Lines
+ * starting with '#' and blank lines are ignored.  For instance, the lines
+ *   qubo2mc -m G1.txt G1.mc
+ *   dechimera -B G2.txt G2.bin
+ * stand for
+ *   Qubo2mc -m < G1.txt > G1.mc
+ *   deChimera -B < G2.txt > G2.bin
+ * The files are converted concurrently: an output must not be the input
+ * of another line.
+ *
+ * The files are converted by a pool of threads, every thread converting the
+ * next file not yet taken.  The files are taken in order of decreasing
+ * size, so that the largest ones start first and the conversions ending
+ * last are short ones.  The edges of a conversion are sorted by the threads
+ * shared equally among the conversions still running: once the workers
+ * have no file left to take, the last, largest files are sorted by the
+ * threads of the workers that are done.
+ *
+ * A file that cannot be converted (an input that cannot be read or is not
+ * a graph of the format of its converter, an output that cannot be
+ * written) does not stop the other conversions: its output, if the
+ * conversion had created it, is removed, and the error is reported at the
+ * end, on standard error and in the summary.  An output that the line did
+ * not reach, e.g. because its input does not exist, is left as it is.
+ *
+ * When all files are converted, a summary line is written to standard
+ * output for every file, in the order of the manifest:
+ *   <converter> <input> <n> <m> <seconds> <isolated> <status>
+ * with the number of nodes and of edges of the output graph, the wall time
+ * of the conversion, the number of isolated nodes removed (by deChimera
+ * only) and "ok", or "failed" (the sizes are then 0), after a header line
+ * starting with '#'.  The exit status is EXIT_FAILURE if any file failed.
+ *
+ * Options:
+ *   -t <threads>: number of threads converting the files (default: 0, the
+ *       number of hardware threads).
+ *   -h: print the usage.
+ */
+#include <fcntl.h>     // For open
+#include <sys/stat.h>  // For the sizes of the files
+#include <unistd.h>    // For getopt, close
+
+#include <algorithm>  // For stable_sort, min, max
+#include <atomic>     // For the next file to convert
+#include <chrono>     // For the times of the conversions
+#include <cstdlib>    // For EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>    // For strcmp, strchr
+#include <exception>  // For the errors of the conversions
+#include <fstream>    // For the manifest
+#include <iomanip>    // For the format of the times
+#include <iostream>   // For the summary and the error messages
+#include <sstream>    // For the fields of the lines of the manifest
+#include <string>     // For the names of the files
+#include <thread>     // For converting the files in parallel
+#include <vector>     // For dynamic arrays (vectors)
+
+#include "converters.h"  // For the conversions
+#include "edge_io.h"     // For buffered input/output of the edges
+
+using namespace std;
+
+enum Converter { kQubo2mc, kDeChimera, kNetRep2mc, kQplib2mc };
+
+struct ConverterName {
+  const char* name;
+  Converter converter;
+  const char* flags;  // the flags it accepts
+};
+const ConverterName kConverters[] = {{"qubo2mc", kQubo2mc, "bBcm"},
+                                     {"dechimera", kDeChimera, "bBm"},
+                                     {"netrep2mc", kNetRep2mc, "B"},
+                                     {"qplib2mc", kQplib2mc, "B"}};
+
+// A file to convert, as given by a line of the manifest.
+struct Job {
+  const ConverterName* converter;
+  bool in_binary = false;   // -b
+  bool out_binary = false;  // -B
+  bool csr = false;         // -c
+  bool merge = false;       // -m
+  string input;
+  string output;
+  off_t size = 0;  // the size of the input
+  ConversionStats stats;
+  double seconds = 0.0;
+  string error;  // why the conversion failed, empty if it did not
+};
+
+//-------------------------------------------------------------------
+// Parses the manifest read from in, named source in the error messages.
+vector<Job> read_manifest(istream& in, const string& source) {
+  vector<Job> jobs;
+  string line;
+  for (size_t k = 1; getline(in, line); ++k) {
+    vector<string> fields;
+    istringstream ss(line);
+    for (string field; ss >> field;) fields.push_back(field);
+    if (fields.empty() || fields[0][0] == '#') continue;
+
+    auto fail = [&](const string& message) {
+      cerr << "*** Line " << k << " of " << source << ": " << message << endl;
+      exit(EXIT_FAILURE);
+    };
+    Job job;
+    job.converter = nullptr;
+    for (const ConverterName& c : kConverters)
+      if (fields[0] == c.name) job.converter = &c;
+    if (job.converter == nullptr) fail("unknown converter " + fields[0]);
+    if (fields.size() < 3) fail("the input and the output are missing");
+    for (size_t f = 1; f + 2 < fields.size(); ++f) {
+      const string& flag = fields[f];
+      if (flag.size() != 2 || flag[0] != '-' ||
+          strchr(job.converter->flags, flag[1]) == nullptr)
+        fail("invalid flag " + flag + " of " + fields[0]);
+      switch (flag[1]) {
+        case 'b':
+          job.in_binary = true;
+          break;
+        case 'B':
+          job.out_binary = true;
+          break;
+        case 'c':
+          job.csr = true;
+          break;
+        case 'm':
+          job.merge = true;
+          break;
+      }
+    }
+    if (job.csr && !job.out_binary) fail("-c requires -B");
+    job.input = fields[fields.size() - 2];
+    job.output = fields.back();
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+
+//-------------------------------------------------------------------
+// Converts the file of job, its edges being sorted by sort_threads()
+// threads.  Throws a GraphError, or the exception of an allocation, if the
+// conversion fails; the output is then removed if the conversion created
+// it.
+void run_conversion(Job& job, int fd, const SortThreads& sort_threads) {
+  if (job.converter->converter == kQplib2mc) {
+    job.stats = qplib2mc(fd, job.input, job.out_binary, job.output);
+    return;
+  }
+  int out_fd = open(job.output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0)
+    throw GraphError("cannot open " + job.output + " for " + job.input);
+  try {
+    GraphOutput out(job.out_binary, out_fd);
+    if (job.converter->converter == kNetRep2mc) {
+      EdgeReader in(fd);
+      job.stats = netRep2mc(in, out);
+    } else {
+      GraphInput in(job.in_binary, fd);
+      if (job.converter->converter == kQubo2mc)
+        job.stats = qubo2mc(in, out, job.csr, job.merge, sort_threads);
+      else
+        job.stats = deChimera(in, out, job.merge);
+    }
+  } catch (...) {
+    close(out_fd);
+    removeOutput(job.output);
+    throw;
+  }  // the output is flushed
+  close(out_fd);
+}
+
+// Converts the file of job as run_conversion.  If this fails, sets
+// job.error.
+void convert(Job& job, const SortThreads& sort_threads) {
+  auto begin = chrono::steady_clock::now();
+  int fd = open(job.input.c_str(), O_RDONLY);
+  if (fd < 0) {
+    job.error = "cannot open " + job.input;
+  } else {
+    try {
+      run_conversion(job, fd, sort_threads);
+    } catch (const exception& e) {
+      job.error = e.what();
+    }
+    close(fd);
+  }
+  if (!job.error.empty()) job.stats = ConversionStats();
+  job.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin)
+                    .count();
+}
+
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-t <threads>] [-h] [<manifest>]" << endl;
+  cerr << " The manifest, read from the file or from standard input, has a "
+       << "line" << endl;
+  cerr << "  <converter> [<flag> ...] <input> <output>" << endl;
+  cerr << " for every file, the converter being one of:" << endl;
+  cerr << "  qubo2mc [-b] [-B] [-c] [-m]: as Qubo2mc" << endl;
+  cerr << "  dechimera [-b] [-B] [-m]: as deChimera" << endl;
+  cerr << "  netrep2mc [-B]: as netRep2mc" << endl;
+  cerr << "  qplib2mc [-B]: as qplib2mc" << endl;
+  cerr << " -t <threads> (>=0) [default: 0]: number of threads converting "
+       << "the files; 0 stands for the number of hardware threads." << endl;
+  cerr << " -h flag: print this message." << endl;
+}
+
+int main(int argc, char** argv) {
+  int n_threads = 0;  // threads converting the files
+  int opt;
+  while ((opt = getopt(argc, argv, "t:h")) != -1) {
+    switch (opt) {
+      case 't':
+        n_threads = atoi(optarg);
+        break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  if (n_threads < 0 || argc - optind > 1) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+  if (n_threads == 0) n_threads = max(1u, thread::hardware_concurrency());
+
+  vector<Job> jobs;
+  if (optind == argc) {
+    jobs = read_manifest(cin, "standard input");
+  } else {
+    ifstream manifest(argv[optind]);
+    if (!manifest.is_open()) {
+      cerr << "Error: File " << argv[optind] << " does not exist!" << endl;
+      exit(EXIT_FAILURE);
+    }
+    jobs = read_manifest(manifest, argv[optind]);
+  }
+
+  // the largest files first; an input that does not exist fails in convert
+  vector<size_t> order(jobs.size());
+  for (size_t k = 0; k != jobs.size(); ++k) {
+    struct stat st;
+    if (stat(jobs[k].input.c_str(), &st) == 0) jobs[k].size = st.st_size;
+    order[k] = k;
+  }
+  stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return jobs[a].size > jobs[b].size;
+  });
+
+  // every worker converts the next file not yet converted; the threads are
+  // shared among the workers still converting to sort the edges
+  size_t n_workers = min<size_t>(n_threads, jobs.size());
+  atomic<unsigned> done(0);  // the workers with no file left to convert
+  SortThreads sort_threads = [&]() -> unsigned {
+    return n_threads / (n_workers - done);
+  };
+  atomic<size_t> next(0);
+  auto run = [&]() {
+    for (size_t k; (k = next++) < order.size();)
+      convert(jobs[order[k]], sort_threads);
+    ++done;
+  };
+  vector<thread> workers;
+  for (size_t w = 0; w < n_workers; ++w) workers.emplace_back(run);
+  for (thread& worker : workers) worker.join();
+
+  bool failed = false;
+  for (const Job& job : jobs)
+    if (!job.error.empty()) {
+      cerr << "Error: " << job.converter->name << ' ' << job.input << ": "
+           << job.error << endl;
+      failed = true;
+    }
+
+  cout << "# converter input n m seconds isolated status" << endl;
+  cout << fixed << setprecision(4);
+  for (const Job& job : jobs)
+    cout << job.converter->name << ' ' << job.input << ' ' << job.stats.n
+         << ' ' << job.stats.m << ' ' << job.seconds << ' '
+         << job.stats.isolated << ' ' << (job.error.empty() ? "ok" : "failed")
+         << endl;
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file graphbin.cpp
+ * @brief This program converts a graph between the text format of the
+ * converters and the binary format of edge_io.h, in both directions.
+ *
+ * Usage: graphbin [-d] [-c] [-h] < in > out
+ *
+ * By default the program reads a text graph and writes it in the binary
+ * format.  The weights are stored as int64 if all of them are integers of
+ * magnitude at most 2^53 (e.g. after scale_img or netRep2mc), as double
+ * otherwise.  Converting the binary graph back to text gives the same graph:
+ * the integer weights are written as integers and the double weights with 6
+ * significant digits, as by the converters.
+ *
+ * Options:
+ *   -d: decode, i.e. read a binary graph and write it in the text format.
+ *   -c: add the CSR section to the binary graph; the edges are then sorted
+ *       (stably) by their first end node, which must be in 1..n.
+ *   -h: print the usage.
+ *
+ * Input Format:
+ *   The input is read from standard input.
+ *   - Without -d, the first line contains two integers: n (number of nodes)
+ *     and m (number of edges), and the subsequent lines (m lines) each
+ *     contain three values: i j w, representing an edge between nodes i and
+ *     j with weight w.  Lines starting with '#' or containing only spaces are
+ *     considered comments and are ignored.
+ *   - With -d, a binary graph.
+ *
+ * Output Format:
+ *   The output is written to standard output, in the other format.
+ */
+
+#include <unistd.h>  // For getopt
+
+#include <cmath>     // For floor
+#include <cstdint>   // For the fixed-size integers of the binary format
+#include <cstdlib>   // For EXIT_SUCCESS, EXIT_FAILURE
+#include <iostream>  // For the error messages
+#include <string>    // For to_string
+#include <vector>    // For using dynamic arrays (vectors)
+
+#include "edge_io.h"  // For the text and binary graph formats
+
+using namespace std;
+
+struct Edge {
+  uint64_t fr;
+  uint64_t to;
+  double wgt;
+};
+
+//-------------------------------------------------------------------
+// Reads a text graph and writes it in the binary format, with the CSR
+// section if csr.
+void encode(bool csr) {
+  GraphInput in(false);
+  in.skip_comments('#');
+  uint64_t n, m;
+  in.read_header(n, m);
+  vector<Edge> E(m);
+  bool integral = true;  // whether all weights are (exact) integers
+  for (Edge& e : E) {
+    in.read_edge(e.fr, e.to, e.wgt);
+    integral = integral && e.wgt == floor(e.wgt) && fabs(e.wgt) <= 0x1p53;
+  }
+
+  vector<uint64_t> off;  // the CSR offsets
+  if (csr) {
+    off.assign(n + 1, 0);
+    for (const Edge& e : E) {
+      if (e.fr < 1 || e.fr > n)
+        throw GraphError("node " + to_string(e.fr) + " of an edge not in 1.." +
+                         to_string(n));
+      ++off[e.fr];
+    }
+    for (uint64_t v = 1; v <= n; ++v) off[v] += off[v - 1];
+    // counting sort, stable
+    vector<uint64_t> next(off.begin(), off.end() - 1);
+    vector<Edge> sorted(m);
+    for (const Edge& e : E) sorted[next[e.fr - 1]++] = e;
+    E = move(sorted);
+  }
+
+  GraphOutput out(true);
+  out.write_header(n, m, integral ? kWeightInt64 : kWeightDouble,
+                   csr ? kGraphHasCSR : 0);
+  for (const Edge& e : E) out.write_edge(e.fr, e.to, e.wgt);
+  if (csr) out.writer().write_bytes(off.data(), off.size() * sizeof(off[0]));
+}
+
+//-------------------------------------------------------------------
+// Reads a binary graph and writes it in the text format.
+void decode() {
+  GraphInput in(true);
+  uint64_t n, m;
+  in.read_header(n, m);
+  GraphOutput out(false);
+  out.write_header(n, m);
+  for (uint64_t k = 0; k != m; ++k) {
+    uint64_t fr, to;
+    if (in.weight_type() == kWeightInt64) {
+      long long int w;
+      in.read_edge(fr, to, w);
+      out.write_edge(fr, to, w);
+    } else {
+      double w;
+      in.read_edge(fr, to, w);
+      out.write_edge(fr, to, w);
+    }
+  }
+}
+
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-d] [-c] [-h] < in > out" << endl;
+  cerr << " Converts a text graph to the binary format." << endl;
+  cerr << " -d flag: converts a binary graph to the text format instead"
+       << endl;
+  cerr << " -c flag: adds the CSR section to the binary graph" << endl;
+  cerr << " -h flag: print this message." << endl;
+}
+
+int main(int argc, char** argv) {
+  bool to_text = false;
+  bool csr = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "dch")) != -1) {
+    switch (opt) {
+      case 'd':
+        to_text = true;
+        break;
+      case 'c':
+        csr = true;
+        break;
+      case 'h':
+      default:
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  if (optind != argc || (to_text && csr)) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  try {
+    if (to_text)
+      decode();
+    else
+      encode(csr);
+  } catch (const GraphError& e) {
+    cerr << "Error: " << e.what() << endl;
+    exit(EXIT_FAILURE);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,270 @@
+/**
+ * @file graphpipe.cpp
+ * @brief This program applies a sequence of graph transformations, as the
+ * chain of the corresponding converters through shell pipes would, in a
+ * single process.
+ *
+ * Usage: graphpipe [-b] [-B] [-h] <transform> [<transform> ...]
+ *
+ * The transforms are applied in the order given:
+ *   - qplib2mc: reads a qplib instance, as qplib2mc does (first transform
+ *     only); unlike qplib2mc the graph goes on to the next transform, or to
+ *     the standard output, rather than to file "<name>.txt".
+ *   - qubo2mc: QUBO to Max-Cut, as Qubo2mc.
+ *   - dechimera: removes the edges of weight 0 and the isolated nodes, as
+ *     deChimera.
+ *   - negate: negates the weights, as negate.
+ *   - scale: scales the weights by 1.0e8 and rounds them, as scale_img.
+ * The output is the same, byte for byte, as the one of the chained
+ * converters, e.g.
+ *   graphpipe qubo2mc dechimera scale  <  in.txt
+ *   Qubo2mc < in.txt | deChimera | scale_img
+ *
+ * The graph is parsed and written once.  negate and scale transform every
+ * edge by itself: consecutive ones are fused and applied to each edge in
+ * a single pass.  If all transforms are of this kind the edges are
+ * streamed, in constant memory; otherwise the graph is held in memory,
+ * since qubo2mc, dechimera and qplib2mc need all edges (node sums, degrees,
+ * sorting), and transformed by the in-memory stages of converters.h, the
+ * ones of the converters themselves.  Every converter writes the weights
+ * with 6 significant digits, and the next one reads this rounded value:
+ * the same rounding is applied between the transforms, so that the results
+ * do not depend on whether the text is actually written.
+ *
+ * Options:
+ *   -b: the input graph is in the binary format of edge_io.h (not with
+ *       qplib2mc).
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       int64 weights if the last transform is scale and double weights
+ *       otherwise.  The weights are still rounded between the transforms as
+ *       above, so that only the precision of the final weights differs from
+ *       the text output.
+ *   -h: print the usage.
+ *
+ * Input Format:
+ *   The input is read from standard input.
+ *   - For qplib2mc, the format of qplib2mc.
+ *   - Otherwise, the first line contains two integers: n (number of nodes)
+ *     and m (number of edges), and the subsequent lines (m lines) each
+ *     contain three values: i j w, representing an edge between nodes i and
+ *     j with weight w.  Unless the first transform is negate, lines starting
+ *     with '#' or containing only spaces are considered comments and are
+ *     ignored, as in the first converter of the chain.
+ *
+ * Output Format:
+ *   The output is written to standard output, in the format of the
+ *   converter of the last transform.
+ */
+
+#include <algorithm>  // For max
+#include <cmath>      // For round
+#include <cstdlib>    // For EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>    // For strcmp
+#include <iostream>   // For the error messages
+#include <string>     // For the error messages
+#include <thread>     // For the threads sorting the edges
+#include <vector>     // For using dynamic arrays (vectors)
+
+#include "converters.h"  // For the stages of qplib2mc, Qubo2mc and deChimera
+#include "edge_io.h"     // For buffered input/output of the edges
+
+using namespace std;
+
+enum Transform { kQplib2mc, kQubo2mc, kDeChimera, kNegate, kScale };
+
+struct TransformName {
+  const char* name;
+  Transform transform;
+};
+const TransformName kTransforms[] = {{"qplib2mc", kQplib2mc},
+                                     {"qubo2mc", kQubo2mc},
+                                     {"dechimera", kDeChimera},
+                                     {"negate", kNegate},
+                                     {"scale", kScale}};
+
+//-------------------------------------------------------------------
+// The value of w once written by a converter and read by the next one.
+double as_written(double w) {
+  char text[64];
+  char* end =
+      to_chars(text, text + sizeof(text), w, chars_format::general, 6).ptr;
+  from_chars(text, end, w);
+  return w;
+}
+
+// The weight written by scale_img, as read by the next converter.
+double scaled(double w) {
+  long long int W = round(w * 1.0e8);
+  return W;
+}
+
+// Applies the fused negate and scale transforms ts to a weight.  If last,
+// the result of the last one is not rounded, since it is written as it is
+// by the program.
+double apply(const vector<Transform>& ts, double w, bool last) {
+  for (size_t k = 0; k != ts.size(); ++k) {
+    if (ts[k] == kScale)
+      w = scaled(w);
+    else
+      w = last && k + 1 == ts.size() ? -w : as_written(-w);
+  }
+  return w;
+}
+
+//-------------------------------------------------------------------
+// Writes an edge; if scale, the weight is first scaled by 1.0e8 and
+// rounded, as scale_img does.
+void write_edge(GraphOutput& out, Index fr, Index to, double w, bool scale) {
+  if (scale) {
+    long long int W = round(w * 1.0e8);
+    out.write_edge(fr, to, W);
+  } else {
+    out.write_edge(fr, to, w);
+  }
+}
+
+//-------------------------------------------------------------------
+// The stages of converters.h, followed unless last by the rounding of the
+// weights as written by their converter.
+
+// Reads a qplib instance and transforms it as qplib2mc does.
+Graph qplib2mc(EdgeReader& in, bool last) {
+  QplibHead h = readQplibHead(in);
+  Graph g = readQplibGraph(in, h);
+  if (!last)
+    for (Edge& e : g.E) e.wgt = as_written(e.wgt);
+  return g;
+}
+
+// QUBO to Max-Cut, as Qubo2mc does.
+void qubo2mc(Graph& g, bool last) {
+  unsigned n_threads = max(1u, thread::hardware_concurrency());
+  quboToMaxCut(g, false, [n_threads]() { return n_threads; });
+  if (!last)
+    for (Edge& e : g.E) e.wgt = as_written(e.wgt);
+}
+
+// Removes the edges of weight 0 and the isolated nodes, as deChimera does.
+// The stage of deChimera holds the edges as a structure of arrays.
+void dechimera(Graph& g, bool last) {
+  Edges edges;
+  edges.reserve(g.E.size());
+  for (const Edge& e : g.E)
+    addNonZeroEdge(edges, g.n, e.fr, e.to, e.wgt, false);
+  vector<Edge>().swap(g.E);  // freed before the edges are copied back
+  g.n = removeIsolated(edges, g.n, false);
+  g.E.reserve(edges.size());
+  for (size_t e = 0; e != edges.size(); ++e)
+    g.E.push_back(Edge(edges.fr[e] + 1, edges.to[e] + 1,
+                       last ? edges.wgt[e] : as_written(edges.wgt[e])));
+}
+
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+  cerr << "Usage: " << program << " [-b] [-B] [-h] <transform> "
+       << "[<transform> ...]" << endl;
+  cerr << " -b flag: the input graph is in the binary format" << endl;
+  cerr << " -B flag: the output graph is written in the binary format" << endl;
+  cerr << " -h flag: print this message." << endl;
+  cerr << " The transforms are applied in the order given:" << endl;
+  cerr << "  qplib2mc: reads a qplib instance (first transform only)" << endl;
+  cerr << "  qubo2mc: QUBO to Max-Cut, as Qubo2mc" << endl;
+  cerr << "  dechimera: removes the edges of weight 0 and the isolated "
+       << "nodes, as deChimera" << endl;
+  cerr << "  negate: negates the weights, as negate" << endl;
+  cerr << "  scale: scales the weights by 1.0e8 and rounds them, as "
+       << "scale_img" << endl;
+}
+
+int main(int argc, char** argv) {
+  bool in_binary, out_binary;
+  parse_format_options(argc, argv, true, in_binary, out_binary,
+                       " <transform> [<transform> ...]");
+  vector<Transform> ts;
+  for (int k = optind; k < argc; ++k) {
+    const TransformName* found = nullptr;
+    for (const TransformName& t : kTransforms)
+      if (strcmp(argv[k], t.name) == 0) found = &t;
+    if (found == nullptr ||
+        (found->transform == kQplib2mc && (k > optind || in_binary))) {
+      if (found == nullptr)
+        cerr << "*** Unknown transform " << argv[k] << endl;
+      else if (in_binary)
+        cerr << "*** qplib2mc reads a text instance" << endl;
+      else if (found != nullptr)
+        cerr << "*** qplib2mc must be the first transform" << endl;
+      print_usage(argv[0]);
+      exit(EXIT_FAILURE);
+    }
+    ts.push_back(found->transform);
+  }
+  if (ts.empty()) {
+    print_usage(argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  try {
+    GraphInput in(in_binary);
+    GraphOutput out(out_binary);
+    if (ts[0] != kQplib2mc && ts[0] != kNegate) in.skip_comments('#');
+    // a final scale is applied when writing, since its integer result may
+    // not be representable as a double
+    bool scale_output = ts.back() == kScale;
+    if (scale_output) ts.pop_back();
+    GraphWeightType type = scale_output ? kWeightInt64 : kWeightDouble;
+
+    bool global = false;  // whether a transform needs the whole graph
+    for (Transform t : ts) global = global || (t != kNegate && t != kScale);
+    if (!global) {
+      Index n, m;
+      in.read_header(n, m);
+      out.write_header(n, m, type);
+      for (Index k = 0; k != m; ++k) {
+        Index i, j;
+        double w;
+        in.read_edge(i, j, w);
+        write_edge(out, i, j, apply(ts, w, !scale_output), scale_output);
+      }
+      return EXIT_SUCCESS;
+    }
+
+    Graph g;
+    size_t first = 0;  // first transform not yet applied
+    if (ts[0] == kQplib2mc) {
+      g = qplib2mc(in.reader(), ts.size() == 1 && !scale_output);
+      first = 1;
+    } else {
+      Index m;
+      in.read_header(g.n, m);
+      g.E.assign(m, Edge(0, 0, 0.0));
+      for (Edge& e : g.E) in.read_edge(e.fr, e.to, e.wgt);
+    }
+    // the negate and scale transforms before every other one are applied to
+    // all edges at once
+    vector<Transform> fused;
+    for (size_t k = first; k != ts.size(); ++k) {
+      if (ts[k] == kNegate || ts[k] == kScale) {
+        fused.push_back(ts[k]);
+        continue;
+      }
+      if (!fused.empty())
+        for (Edge& e : g.E) e.wgt = apply(fused, e.wgt, false);
+      fused.clear();
+      bool last = k + 1 == ts.size() && !scale_output;
+      if (ts[k] == kQubo2mc)
+        qubo2mc(g, last);
+      else
+        dechimera(g, last);
+    }
+
+    out.write_header(g.n, g.E.size(), type);
+    for (const Edge& e : g.E)
+      write_edge(out, e.fr, e.to, apply(fused, e.wgt, !scale_output),
+                 scale_output);
+  } catch (const GraphError& e) {
+    cerr << "Error: " << e.what() << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return EXIT_SUCCESS;
+}
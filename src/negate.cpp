@@ -6,6 +6,15 @@
  * For each edge, it negates the weight and outputs the modified edge to standard output.
  * The graph's structure (number of nodes and edges) remains unchanged.
  *
+ * The edges are streamed: each one is written as soon as it is read, through
+ * the buffered reader and writer of edge_io.h, so that memory is constant.
+ *
+ * Options:
+ *   -b: the input graph is in the binary format of edge_io.h.
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       double weights, exactly instead of with 6 significant digits.
+ *   -h: print the usage.
+ *
  * Input Format:
  *   The input is read from standard input (std::cin).
  *   - The first line contains two integers: n (number of nodes) and m (number of edges).
@@ -17,27 +26,39 @@
  *   - Subsequent lines (m lines) each contain three values: a b -w, representing an edge from node a to node b with the negated weight -w.
  */
 
+#include <cstdlib>
 #include <iostream>
 
+#include "edge_io.h"
+
 using namespace std;
 
-int main() {
+int main(int argc, char** argv) {
     int n, m, a, b;
     double w;
+    bool in_binary, out_binary;
+    parse_format_options(argc, argv, true, in_binary, out_binary);
+    try {
+        GraphInput in(in_binary);
+        GraphOutput out(out_binary);
 
-    // Read the number of nodes (n) and edges (m).
-    cin >> n >> m;
+        // Read the number of nodes (n) and edges (m).
+        in.read_header(n, m);
 
-    // Output the number of nodes and edges.
-    cout << n << " " << m << endl;
+        // Output the number of nodes and edges.
+        out.write_header(n, m);
 
-    // Iterate through each edge.
-    for (int i = 0; i != m; ++i) {
-        // Read the source node (a), destination node (b), and weight (w) of the edge.
-        cin >> a >> b >> w;
+        // Iterate through each edge.
+        for (int i = 0; i != m; ++i) {
+            // Read the source node (a), destination node (b), and weight (w) of the edge.
+            in.read_edge(a, b, w);
 
-        // Output the source node (a), destination node (b), and negated weight (-w).
-        cout << a << " " << b << " " << -w << endl;
+            // Output the source node (a), destination node (b), and negated weight (-w).
+            out.write_edge(a, b, -w);
+        }
+    } catch (const GraphError& e) {
+        cerr << "Error: " << e.what() << endl;
+        exit(EXIT_FAILURE);
     }
 
     return EXIT_SUCCESS;
@@ -0,0 +1,132 @@
+/**
+ * @file profiler.h
+ * @brief Wall times and call counts of the stages of a program, and
+ * counters of the work they do, reported as one JSON line.
+ *
+ * A stage is timed by a ScopedStage living as long as it runs; a counter is
+ * increased by Profiler::count.  Both do nothing unless the profiler is
+ * enabled, at the cost of a test of a flag, so that they can be left in the
+ * code for good.  Stages are identified by their name, a string literal;
+ * nested stages are timed independently (the time of a stage includes the
+ * ones of the stages it calls).  Stages can run in any thread; the times of
+ * stages running concurrently overlap.
+ *
+ * The JSON line has the form
+ *   {"program":"tablegenerator","wall_ns":1234,"peak_rss_bytes":5678,
+ *    "stages":{"read_results_file":{"calls":1,"wall_ns":1000},...},
+ *    "counters":{"bytes_read":4096,...}}
+ * with the stages in order of first completion and the counters in order
+ * of first use, so that the lines of successive runs can be compared.
+**/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+class Profiler {
+ public:
+  bool enabled = false;
+
+  // Restarts the profile: all stages and counters are cleared.
+  void start() {
+    stages.clear();
+    counters.clear();
+    begin = std::chrono::steady_clock::now();
+  }
+
+  // Adds a call of stage name lasting ns nanoseconds.
+  void add(const char* name, std::uint64_t ns) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry& e = entry(stages, name);
+    ++e.calls;
+    e.value += ns;
+  }
+
+  // Adds n to counter name.
+  void count(const char* name, std::uint64_t n) {
+    if (!enabled) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    entry(counters, name).value += n;
+  }
+
+  // Writes the profile as one JSON line, program being the name of the
+  // program.
+  void write_json(std::ostream& out, const char* program) const {
+    out << "{\"program\":\"" << program << "\",\"wall_ns\":" << since(begin)
+        << ",\"peak_rss_bytes\":" << peak_rss() << ",\"stages\":{";
+    for (std::size_t k = 0; k != stages.size(); ++k)
+      out << (k == 0 ? "" : ",") << '"' << stages[k].name
+          << "\":{\"calls\":" << stages[k].calls
+          << ",\"wall_ns\":" << stages[k].value << '}';
+    out << "},\"counters\":{";
+    for (std::size_t k = 0; k != counters.size(); ++k)
+      out << (k == 0 ? "" : ",") << '"' << counters[k].name
+          << "\":" << counters[k].value;
+    out << "}}" << std::endl;
+  }
+
+  // Nanoseconds elapsed since t.
+  static std::uint64_t since(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - t)
+        .count();
+  }
+
+  // Peak resident set size of the process, in bytes.
+  static std::uint64_t peak_rss() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;  // in KiB
+  }
+
+ private:
+  struct Entry {
+    const char* name;
+    std::uint64_t calls;
+    std::uint64_t value;  // nanoseconds of a stage, value of a counter
+  };
+  std::vector<Entry> stages, counters;  // in order of appearance
+  std::mutex mutex;                     // guards them
+  std::chrono::steady_clock::time_point begin =
+      std::chrono::steady_clock::now();
+
+  // The entry of name, added if needed; there are few of them.
+  static Entry& entry(std::vector<Entry>& entries, const char* name) {
+    for (Entry& e : entries)
+      if (e.name == name || std::strcmp(e.name, name) == 0) return e;
+    entries.push_back({name, 0, 0});
+    return entries.back();
+  }
+};
+
+// The profiler of the program.
+inline Profiler profiler;
+
+// Times stage name from its construction to its destruction, if the
+// profiler is enabled at its construction.
+class ScopedStage {
+ public:
+  explicit ScopedStage(const char* name)
+      : name(profiler.enabled ? name : nullptr) {
+    if (this->name != nullptr) begin = std::chrono::steady_clock::now();
+  }
+  ~ScopedStage() {
+    if (name != nullptr) profiler.add(name, Profiler::since(begin));
+  }
+  ScopedStage(const ScopedStage&) = delete;
+  ScopedStage& operator=(const ScopedStage&) = delete;
+
+ private:
+  const char* name;
+  std::chrono::steady_clock::time_point begin;
+};
+
+#endif  // PROFILER_H
@@ -35,153 +35,146 @@
  *
  * Comments in the input file start with '#'.
  * The output file is named after the input filename with ".txt" appended.
+ *
+ * Usage: qplib2mc [-B] [-t <threads>] [-h] [<file> ...]
+ *
+ * The instances are read from the files given or, if none, from standard
+ * input.  Each file is converted by one of the threads, so that the whole
+ * qplib library can be converted in a single invocation.  Two files whose
+ * instances have the same name, and so the same output file, are rejected
+ * before any conversion.  A file that cannot be converted does not stop the
+ * others: its output, if it was created, is removed, and the errors are
+ * reported once all the files are done, the exit status being then 1.
+ *
+ * Only O(n) values are held in memory, the sum of the weights and the loop
+ * of every node.  A first pass over the input computes them, and so the
+ * number of added loop elements; a second pass reads the edges again and
+ * streams them to the output, followed by the loop elements.  If the input
+ * cannot be read twice (standard input from a pipe), the edges are held in
+ * memory in between.  The conversion itself is in converters.h, shared
+ * with graphbatch.
+ *
+ * Options:
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       double weights, to the file named after the input filename with
+ *       ".bin" appended.
+ *   -t <threads>: number of threads converting the files (default: 0, the
+ *       number of hardware threads).
+ *   -h: print the usage.
  */
-#include <cassert>   // For assertions (debugging aid)
-#include <cctype>    // For character handling (not used in this version, but might have been used previously)
-#include <fstream>   // For file I/O (ofstream, ifstream)
-#include <iostream>  // For console I/O (cin, cout)
-#include <string>    // For string manipulation
-#include <vector>    // For dynamic arrays (vectors)
-#include <limits>    // For numeric limits (e.g., max of streamsize)
-#include <numeric>   // For numerical algorithms (not directly used in the current code, but might have been in earlier versions)
+#include <fcntl.h>   // For open
+#include <unistd.h>  // For getopt, close
 
-using namespace std;
-
-// Function to skip comment lines or lines with only spaces in an input stream.
-// Comments start with '#' and extend to the end of the line.
-void skipComment(istream& f) {
-    char ch;
-    // Read characters until a non-comment/non-space character is encountered or the end of the stream is reached.
-    while (f.get(ch) && (ch == '#' || ch == ' ')) {
-        // Ignore all characters until the end of the line.
-        f.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); 
-    }
-    // If a non-comment/non-space character was found, put it back into the stream.
-    if (f.good()) { 
-        f.unget(); 
-    }
-}
+#include <algorithm>      // For min
+#include <atomic>         // For the next file to convert
+#include <cstdlib>        // For EXIT_SUCCESS, EXIT_FAILURE
+#include <fstream>        // For the names of the instances
+#include <iostream>       // For the error messages
+#include <string>         // For the names of the files
+#include <thread>         // For converting the files in parallel
+#include <unordered_map>  // For the files of every output
+#include <vector>         // For dynamic arrays (vectors)
 
-int main() {
-    string name;         // Variable to store the input file's name (without extension).
-    string nameOut;      // Variable to store the output file's name (with ".txt" extension).
-    int n, m;            // 'n' is the number of nodes, 'm' is the number of edges in the graph.
+#include "converters.h"  // For the conversion itself
 
-    // Read the first line from standard input (usually the filename).
-    getline(cin, name);
-    // Construct the output filename by appending ".txt" to the input filename.
-    nameOut = name + ".txt";
-
-    // Skip the second and third lines of the input (as per the problem's specification).
-    getline(cin, name); 
-    getline(cin, name); 
-
-    // Read the number of nodes 'n' from the input.
-    cin >> n;
-    // Skip any comment lines or blank lines following the value of n.
-    skipComment(cin);
-
-    // Create a vector 'Sum' of size 'n', initialized with 0.0.
-    // 'Sum[i]' will store the sum of weights connected to node 'i'.
-    vector<double> Sum(n, 0.0); 
-    // Create a vector 'Diag' of size 'n' to store diagonal values.
-    vector<double> Diag(n);
-    
-    double Obj = 0.0; // This variable is declared but not used. It might be part of a larger algorithm or a previous version of the code
-
-    // Read the number of edges 'm' from the input.
-    cin >> m;
-    // Skip any comment lines or blank lines following the value of m.
-    skipComment(cin);
-
-    // Create vectors to store the edges of the graph.
-    vector<int> fr(m);    // 'fr[i]' is the source node of the i-th edge.
-    vector<int> to(m);    // 'to[i]' is the destination node of the i-th edge.
-    vector<double> c(m);  // 'c[i]' is half the weight of the i-th edge.
+using namespace std;
 
-    // Read the edges and their weights from the input.
-    for (int i = 0; i < m; ++i) {
-        int u, v;   // Temporary variables for source and destination nodes.
-        double w;  // Temporary variable for the edge's weight.
+//-------------------------------------------------------------------
+void print_usage(const char* program) {
+    cerr << "Usage: " << program << " [-B] [-t <threads>] [-h] [<file> ...]"
+         << endl;
+    cerr << " The instances are read from the files, or from standard input."
+         << endl;
+    cerr << " -B flag: the output graph is written in the binary format"
+         << endl;
+    cerr << " -t <threads> (>=0) [default: 0]: number of threads converting "
+         << "the files; 0 stands for the number of hardware threads." << endl;
+    cerr << " -h flag: print this message." << endl;
+}
 
-        cin >> u >> v >> w; // Read the source node, destination node, and weight of the i-th edge.
-        --u;        // Adjust the node indices to be 0-based (input is 1-based).
-        --v;        // Adjust the node indices to be 0-based.
-        assert(u >= 0 && u < n); // Check if the node indices are within the valid range.
-        assert(v >= 0 && v < n); // Check if the node indices are within the valid range.
-        fr[i] = u; // Store the source node of the i-th edge.
-        to[i] = v; // Store the destination node of the i-th edge.
-        c[i] = w / 2; // Store half the weight of the i-th edge.
-        Sum[u] += c[i]; // Add half the weight to the sum of weights for the source node.
-        Sum[v] += c[i]; // Add half the weight to the sum of weights for the destination node.
+int main(int argc, char** argv) {
+    bool out_binary = false;  // whether the output is binary
+    int n_threads = 0;        // threads converting the files
+    int opt;
+    while ((opt = getopt(argc, argv, "Bt:h")) != -1) {
+        switch (opt) {
+            case 'B':
+                out_binary = true;
+                break;
+            case 't':
+                n_threads = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
     }
-
-    double z;  // Variable to store the initial diagonal value.
-    int nd;    // Variable to store the number of additional diagonal entries.
-
-    // Read the initial diagonal value 'z' from the input.
-    cin >> z;
-    // Skip any comment lines or blank lines following the value of z.
-    skipComment(cin);
-
-    // Fill the 'Diag' vector with the initial diagonal value 'z'.
-    fill(Diag.begin(), Diag.end(), z); 
-
-    // Read the number of additional diagonal entries 'nd' from the input.
-    cin >> nd;
-    // Skip any comment lines or blank lines following the value of nd.
-    skipComment(cin);
-
-    // Read the additional diagonal entries and update the 'Diag' vector.
-    for (int i = 0; i < nd; ++i) {
-        int u;   // Temporary variable for the node index.
-        double w; // Temporary variable for the diagonal value.
-
-        cin >> u >> w; // Read the node index and the diagonal value.
-        --u;           // Adjust the node index to be 0-based.
-        Diag[u] = w; // Update the diagonal value for the specified node.
+    if (n_threads < 0) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
     }
-
-    // Create vectors to store the diagonal entries that will be added to the output.
-    vector<int> fr_diag;   // Source nodes for the added diagonal entries.
-    vector<int> to_diag;   // Destination nodes for the added diagonal entries.
-    vector<double> c_diag; // Weights for the added diagonal entries.
-
-    // Iterate through all the nodes to generate the diagonal elements.
-    for (int i = 0; i < n; ++i) {
-        // Calculate the diagonal value for the i-th node.
-        double val = -2 * Diag[i] - Sum[i];
-        // If the diagonal value is non-zero, add it to the new vectors.
-        if (val != 0.0) {
-            fr_diag.push_back(i);      // Store the node index as the source.
-            to_diag.push_back(n);     // Store 'n' as the destination (special case for diagonal).
-            c_diag.push_back(val);    // Store the diagonal value.
+    if (n_threads == 0) n_threads = max(1u, thread::hardware_concurrency());
+
+    if (optind == argc) {
+        try {
+            qplib2mc(STDIN_FILENO, "standard input", out_binary);
+        } catch (const GraphError& e) {
+            cerr << "Error: " << e.what() << endl;
+            exit(EXIT_FAILURE);
         }
+        return EXIT_SUCCESS;
     }
-    nd = fr_diag.size(); // Update nd to represent the new number of diagonal entries
-    
-    // If there are any new diagonal elements, increment n to account for the dummy node.
-    if (nd > 0)
-       ++n;
 
-    // Open the output file.
-    ofstream out(nameOut);
-
-    // Write the number of nodes and edges to the output file.
-    out << n << " " << m + nd << endl; 
-
-    // Write the edge data to the output file.
-    for (int i = 0; i < m; ++i) {
-        out << fr[i] + 1 << " " << to[i] + 1 << " " << -c[i] / 2.0 << endl;
-    }
-
-    // Write the diagonal data to the output file.
-    for(int i = 0; i < nd; ++i){
-        out << fr_diag[i] + 1 << " " << to_diag[i] + 1 << " " << -c_diag[i] / 2.0 << endl;
+    // the output of every file, named after its instance on its first line
+    vector<string> files(argv + optind, argv + argc);
+    vector<string> outputs(files.size());
+    vector<string> errors(files.size());  // empty if the file is converted
+    unordered_map<string, size_t> output_file;  // the file of every output
+    for (size_t k = 0; k != files.size(); ++k) {
+        ifstream in(files[k]);
+        if (!in.is_open()) {
+            errors[k] = "cannot open";
+            continue;
+        }
+        getline(in, outputs[k]);
+        outputs[k] += out_binary ? ".bin" : ".txt";
+        auto [it, added] = output_file.emplace(outputs[k], k);
+        if (!added) {
+            cerr << "Error: " << files[it->second] << " and " << files[k]
+                 << " would both be written to " << outputs[k] << endl;
+            exit(EXIT_FAILURE);
+        }
     }
-    
-    // Close the output file.
-    out.close();
 
-    return EXIT_SUCCESS;
+    // every worker converts the next file not yet converted
+    atomic<size_t> next(0);
+    auto run = [&]() {
+        for (size_t k; (k = next++) < files.size();) {
+            if (!errors[k].empty()) continue;
+            int fd = open(files[k].c_str(), O_RDONLY);
+            if (fd < 0) {
+                errors[k] = "cannot open";
+                continue;
+            }
+            try {
+                qplib2mc(fd, files[k], out_binary, outputs[k]);
+            } catch (const exception& e) {
+                errors[k] = e.what();
+            }
+            close(fd);
+        }
+    };
+    size_t n_workers = min<size_t>(n_threads, files.size());
+    vector<thread> workers;
+    for (size_t w = 0; w < n_workers; ++w) workers.emplace_back(run);
+    for (thread& worker : workers) worker.join();
+
+    bool failed = false;
+    for (size_t k = 0; k != files.size(); ++k)
+        if (!errors[k].empty()) {
+            cerr << "Error: " << files[k] << ": " << errors[k] << endl;
+            failed = true;
+        }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
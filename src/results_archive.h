@@ -0,0 +1,1050 @@
+/**
+ * @file results_archive.h
+ * @brief Compiled, memory-mappable form of the results file read by
+ * tablegenerator.
+ *
+ * The results file is a CSV with one row per execution:
+ *   timestamp,graphname,algorithm,seed,time_limit,objective,time,history
+ * where history is a sequence of "value:time" pairs separated by ';'.
+ *
+ * A ResultsArchive holds the same information in columnar form:
+ *   - the instance, algorithm and seed names, interned in order of first
+ *     appearance, so that every row refers to them by a dense id;
+ *   - for every row: the ids, the time limit, the objective and the time;
+ *   - the history of every row, split once into flat arrays of values and
+ *     times, with per-row offsets into them.
+ * It also holds the display names of the algorithms, read by tablegenerator
+ * from their own file, so that a cache provides everything the tables are
+ * made of.
+ * Objectives, times and history entries are converted once into Decimal
+ * (see decimal.h), so that neither loading nor comparing them requires any
+ * string processing.
+ *
+ * An archive is either built by parsing the text file or mapped in memory
+ * from a binary cache written by a previous compilation.  In the latter case
+ * no parsing at all takes place: every column is read in place from the
+ * mapped file.
+ *
+ * Binary cache layout (all integers in native byte order, see
+ * section_file.h):
+ *   - a fixed size CacheHeader, with the size and modification time of the
+ *     text file it was compiled from and of the display names file, if any,
+ *     whose name is the section kDisplaySource;
+ *   - kSections sections, each aligned to kSectionAlignment bytes, whose
+ *     offsets and sizes are recorded in the header.
+ * Names are stored as an array of n+1 offsets followed by a section with
+ * all their characters, name k being chars[off[k], off[k+1]); all other
+ * columns are plain arrays.
+**/
+
+#ifndef RESULTS_ARCHIVE_H
+#define RESULTS_ARCHIVE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "csv.h"
+#include "decimal.h"
+#include "section_file.h"
+
+//-------------------------------------------------------------------
+// Read-only view of a contiguous array, either owned by a vector of the
+// archive or living inside the mapped cache file.
+template <class T>
+struct ArrayView {
+  const T* data = nullptr;
+  std::size_t size = 0;
+
+  const T& operator[](std::size_t k) const { return data[k]; }
+};
+
+// A column of strings: string k is chars[off[k], off[k+1]).
+struct StringColumn {
+  ArrayView<std::uint64_t> off;
+  ArrayView<char> chars;
+
+  std::size_t size() const { return off.size == 0 ? 0 : off.size - 1; }
+  std::string_view operator[](std::size_t k) const {
+    return std::string_view(chars.data + off[k], off[k + 1] - off[k]);
+  }
+
+  // Whether the offsets are non-decreasing, the last one ending chars, so
+  // that every string is within chars (e.g. of a mapped file).
+  bool valid() const {
+    return off.size > 0 && off[size()] == chars.size &&
+           std::is_sorted(off.data, off.data + off.size);
+  }
+};
+
+// Growable counterpart of StringColumn used while parsing.
+struct StringColumnBuilder {
+  std::vector<std::uint64_t> off{0};
+  std::vector<char> chars;
+
+  void push_back(std::string_view s) {
+    chars.insert(chars.end(), s.begin(), s.end());
+    off.push_back(chars.size());
+  }
+  StringColumn view() const {
+    return {{off.data(), off.size()}, {chars.data(), chars.size()}};
+  }
+};
+
+// Names interned in order of first appearance: name k is stored in a single
+// arena of characters, as in a StringColumnBuilder, and found by an open
+// addressing table of ids keyed by the names themselves, so that looking up
+// or adding a name costs one hash of its characters and no allocation.
+class StringInterner {
+ public:
+  static constexpr std::uint32_t kNone =
+      std::numeric_limits<std::uint32_t>::max();
+
+  std::size_t size() const { return hashes.size(); }
+  std::string_view operator[](std::size_t k) const {
+    return std::string_view(names.chars.data() + names.off[k],
+                            names.off[k + 1] - names.off[k]);
+  }
+  StringColumn view() const { return names.view(); }
+
+  // The id of name, or kNone if it has not been interned.
+  std::uint32_t find(std::string_view name) const {
+    if (slots.empty()) return kNone;
+    std::uint64_t h = hash(name);
+    for (std::size_t s = h & mask();; s = (s + 1) & mask()) {
+      std::uint32_t id = slots[s];
+      if (id == kNone) return kNone;
+      if (hashes[id] == h && (*this)[id] == name) return id;
+    }
+  }
+
+  // The id of name, which is added if new.
+  std::uint32_t intern(std::string_view name) {
+    if (2 * (size() + 1) > slots.size()) grow();
+    std::uint64_t h = hash(name);
+    std::size_t s = h & mask();
+    for (;; s = (s + 1) & mask()) {
+      std::uint32_t id = slots[s];
+      if (id == kNone) break;
+      if (hashes[id] == h && (*this)[id] == name) return id;
+    }
+    slots[s] = static_cast<std::uint32_t>(size());
+    hashes.push_back(h);
+    names.push_back(name);
+    return slots[s];
+  }
+
+  // Keeps the first n names only.
+  void truncate(std::size_t n) {
+    if (n >= size()) return;
+    StringInterner kept;
+    for (std::size_t k = 0; k != n; ++k) kept.intern((*this)[k]);
+    *this = std::move(kept);
+  }
+
+  // Interns the names of column, in order, after clearing the interner.
+  void assign(const StringColumn& column) {
+    clear();
+    for (std::size_t k = 0; k != column.size(); ++k) intern(column[k]);
+  }
+
+  void clear() {
+    names = StringColumnBuilder();
+    hashes.clear();
+    slots.clear();
+  }
+
+ private:
+  StringColumnBuilder names;        // the arena
+  std::vector<std::uint64_t> hashes;  // of every name
+  std::vector<std::uint32_t> slots;   // ids, kNone for the empty slots
+
+  std::size_t mask() const { return slots.size() - 1; }
+
+  static std::uint64_t hash(std::string_view name) {
+    return std::hash<std::string_view>()(name);
+  }
+
+  // Doubles the table, keeping it at most half full.
+  void grow() {
+    slots.assign(std::max<std::size_t>(16, 2 * slots.size()), kNone);
+    for (std::uint32_t id = 0; id != size(); ++id) {
+      std::size_t s = hashes[id] & mask();
+      while (slots[s] != kNone) s = (s + 1) & mask();
+      slots[s] = id;
+    }
+  }
+};
+
+//-------------------------------------------------------------------
+class ResultsArchive {
+ public:
+  static constexpr std::uint32_t kVersion = 4;
+
+  // Index of every section in the binary cache.
+  enum Section {
+    kInstNameOff,
+    kInstNameChars,
+    kAlgNameOff,
+    kAlgNameChars,
+    kSeedNameOff,
+    kSeedNameChars,
+    kRecInst,
+    kRecAlg,
+    kRecSeed,
+    kRecLimit,
+    kRecObjective,
+    kRecTime,
+    kRecHistBegin,
+    kHistValue,
+    kHistTime,
+    kHistTimeValue,
+    kDisplayKeyOff,
+    kDisplayKeyChars,
+    kDisplayValueOff,
+    kDisplayValueChars,
+    kDisplaySource,
+    kSections
+  };
+
+  struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t source_size;
+    std::int64_t source_mtime_ns;
+    std::uint64_t n_records;
+    std::uint64_t n_history;
+    std::uint64_t n_lines;
+    std::uint64_t names_present;  // the display names below are meaningful
+    std::uint64_t names_size;
+    std::int64_t names_mtime_ns;
+    std::uint64_t section_offset[kSections];
+    std::uint64_t section_size[kSections];
+  };
+
+  // Columns of the archive.  They point either into the builders below or
+  // into the mapped cache file.
+  StringColumn inst_names, alg_names, seed_names;
+  ArrayView<std::uint32_t> rec_inst, rec_alg, rec_seed;
+  ArrayView<double> rec_limit;
+  ArrayView<Decimal> rec_objective, rec_time;
+  ArrayView<std::uint64_t> rec_hist_begin;  // n_records + 1 offsets
+  ArrayView<Decimal> hist_value, hist_time;
+  ArrayView<double> hist_time_value;        // time of the entry, as a double
+  std::uint64_t n_lines = 0;                // data lines in the text file
+  std::uint64_t bytes_read = 0;  // bytes of the files parsed or mapped
+  // display name display_values[k] of every algorithm display_keys[k], as
+  // set by set_display_names
+  StringColumn display_keys, display_values;
+
+  ResultsArchive() = default;
+  ResultsArchive(const ResultsArchive&) = delete;
+  ResultsArchive& operator=(const ResultsArchive&) = delete;
+  ~ResultsArchive() { unmap(); }
+
+  std::size_t n_records() const { return rec_inst.size; }
+
+  // Name of the binary cache associated to a results file.
+  static std::string cache_name(const std::string& results) {
+    return results + ".cache";
+  }
+
+  // Outcome of locating a time limit in the history of a record: either the
+  // offset of a history entry relative to the beginning of the history of
+  // the record, or one of the following codes.
+  static constexpr std::int32_t kUseColumns = -1;  // objective, time apply
+  static constexpr std::int32_t kNoneWithinLimit = -2;  // value and time "0"
+
+  // Locates the last history entry of record r whose time is within limit.
+  // When this is the last entry of the history (or there is no history),
+  // the objective and time columns of the record apply.
+  std::int32_t locate(std::size_t r, double limit) const {
+    std::uint64_t begin = rec_hist_begin[r];
+    std::uint64_t end = rec_hist_begin[r + 1];
+    if (begin == end) return kUseColumns;
+    for (std::uint64_t k = end; k-- > begin;)
+      if (hist_time_value[k] <= limit)
+        return k == end - 1 ? kUseColumns : static_cast<std::int32_t>(k - begin);
+    return kNoneWithinLimit;
+  }
+
+  // Same as above for n limits in decreasing order, in a single backward
+  // walk of the history: every entry rejected for a limit is also rejected
+  // for all smaller ones, so the walk resumes where the previous limit
+  // stopped.
+  void locate(std::size_t r, const double* limits, std::size_t n,
+              std::int32_t* out) const {
+    std::uint64_t begin = rec_hist_begin[r];
+    std::uint64_t end = rec_hist_begin[r + 1];
+    std::uint64_t k = end;  // entries in [k, end) are beyond the limit
+    for (std::size_t l = 0; l != n; ++l) {
+      while (k > begin && !(hist_time_value[k - 1] <= limits[l])) --k;
+      if (begin == end || k == end)
+        out[l] = kUseColumns;
+      else if (k == begin)
+        out[l] = kNoneWithinLimit;
+      else
+        out[l] = static_cast<std::int32_t>(k - 1 - begin);
+    }
+  }
+
+  // Number of history entries of record r examined by locate to find
+  // located (by the second form, the outcome for the smallest limit).
+  std::uint64_t scanned(std::size_t r, std::int32_t located) const {
+    std::uint64_t length = rec_hist_begin[r + 1] - rec_hist_begin[r];
+    if (length == 0) return 0;
+    if (located == kUseColumns) return 1;
+    if (located == kNoneWithinLimit) return length;
+    return length - located;
+  }
+
+  // Value and time of record r for the outcome of locate.
+  std::pair<Decimal, Decimal> value_of(std::size_t r,
+                                       std::int32_t located) const {
+    if (located == kNoneWithinLimit) return {Decimal(), Decimal()};
+    if (located == kUseColumns) return {rec_objective[r], rec_time[r]};
+    std::uint64_t k = rec_hist_begin[r] + located;
+    return {hist_value[k], hist_time[k]};
+  }
+
+  // Value and time of record r when its time limit is limit.
+  std::pair<Decimal, Decimal> value_at(std::size_t r, double limit) const {
+    return value_of(r, locate(r, limit));
+  }
+
+  // Stores the display names of the algorithms, pairs of (name, display
+  // name), read from the file source, whose name is kept as well.
+  void set_display_names(
+      const std::vector<std::pair<std::string, std::string>>& names,
+      const std::string& source) {
+    b_display_keys = b_display_values = StringColumnBuilder();
+    for (const auto& [name, display] : names) {
+      b_display_keys.push_back(name);
+      b_display_values.push_back(display);
+    }
+    display_keys = b_display_keys.view();
+    display_values = b_display_values.view();
+    names_present = source_stat(source, names_size, names_mtime_ns);
+    names_source = source;
+  }
+
+  // Whether the display names were set from the file source, and source
+  // has not been modified since.
+  bool display_names_fresh(const std::string& source) const {
+    std::uint64_t size;
+    std::int64_t mtime;
+    return names_present && source == names_source &&
+           source_stat(source, size, mtime) && size == names_size &&
+           mtime == names_mtime_ns;
+  }
+
+  //-----------------------------------------------------------------
+  // Parses the text results file with up to threads threads.  Returns false
+  // if it cannot be opened.  On an invalid number the error is reported and
+  // the program exits, unless error is not null: then false is returned
+  // too, with the message in *error, and the archive is left empty.
+  //
+  // The file is mapped in memory and its data lines are split into chunks
+  // of whole lines, every chunk being parsed by its own thread into a
+  // partial archive, in which names are interned independently.  The partial
+  // archives are then appended in file order, so that names are numbered in
+  // order of first appearance and records are stored in file order, exactly
+  // as if the file were parsed by a single thread.
+  bool parse(const std::string& filename, unsigned threads = 1,
+             std::string* error = nullptr) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      if (error != nullptr) *error = "File " + filename + " does not exist";
+      return false;
+    }
+    clear_builders();
+    struct stat st;
+    std::size_t size = 0;
+    void* addr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      size = st.st_size;
+      addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    std::string contents;  // the file, when it cannot be mapped
+    const char* text;
+    if (addr != MAP_FAILED) {
+      text = static_cast<const char*>(addr);
+    } else {
+      std::ifstream fin(filename, std::ios::binary);
+      if (!fin.is_open()) {
+        if (error != nullptr) *error = "File " + filename + " does not exist";
+        return false;
+      }
+      contents.assign(std::istreambuf_iterator<char>(fin),
+                      std::istreambuf_iterator<char>());
+      text = contents.data();
+      size = contents.size();
+    }
+
+    // file results contains a header in the first row, which we skip
+    const char* end = text + size;
+    const char* begin = static_cast<const char*>(std::memchr(text, '\n', size));
+    begin = begin == nullptr ? end : begin + 1;
+    std::vector<const char*> bounds = split_lines(begin, end, threads);
+    std::size_t nchunks = bounds.size() - 1;
+    // reports the error of part, whose lines follow line_offset lines
+    auto fail = [&](const ResultsArchive& part, std::uint64_t line_offset) {
+      if (error == nullptr) part.report_error(line_offset);
+      *error = part.error_message(line_offset);
+      if (addr != MAP_FAILED) munmap(addr, size);
+      clear_builders();
+      point_to_builders();
+      return false;
+    };
+    if (nchunks == 1) {
+      if (!parse_lines(begin, end)) return fail(*this, 0);
+    } else {
+      std::vector<ResultsArchive> parts(nchunks);
+      std::vector<std::thread> workers;
+      for (std::size_t k = 0; k != nchunks; ++k)
+        workers.emplace_back([&parts, &bounds, k]() {
+          parts[k].parse_lines(bounds[k], bounds[k + 1]);
+        });
+      for (std::thread& w : workers) w.join();
+      // the first error in file order is reported, as a serial parse would
+      for (ResultsArchive& part : parts) {
+        if (part.failed) return fail(part, n_lines);
+        append(part);
+        part.clear_builders();
+      }
+    }
+    if (addr != MAP_FAILED) munmap(addr, size);
+    point_to_builders();
+    bytes_read = size;
+    return true;
+  }
+
+  //-----------------------------------------------------------------
+  // Parses the data lines in [begin, end), made of whole lines, into the
+  // archive, replacing its records; the results file has line_offset data
+  // lines before them, for the error messages.  See ResultsStream.
+  void parse_chunk(const char* begin, const char* end,
+                   std::uint64_t line_offset) {
+    clear_builders();
+    if (!parse_lines(begin, end)) report_error(line_offset);
+    point_to_builders();
+  }
+
+  //-----------------------------------------------------------------
+  // Parses the text results file filename, with up to threads threads, and
+  // appends its records to the archive, as if its data lines followed the
+  // ones the archive was built from.  Only filename is parsed; if the
+  // archive is mapped from a cache, its columns are first copied in memory.
+  // Returns false if filename cannot be opened and, if error is not null,
+  // if it has an invalid number, as parse; the archive is then unchanged.
+  bool append_file(const std::string& filename, unsigned threads = 1,
+                   std::string* error = nullptr) {
+    ResultsArchive delta;
+    if (!delta.parse(filename, threads, error)) return false;
+    own();
+    append(delta);
+    point_to_builders();
+    bytes_read += delta.bytes_read;
+    return true;
+  }
+
+  // The size of the archive, to which truncate brings it back.
+  struct Mark {
+    std::uint64_t n_records, n_inst_names, n_alg_names, n_seed_names;
+    std::uint64_t n_lines, bytes_read;
+  };
+  Mark mark() const {
+    return {n_records(),      inst_names.size(), alg_names.size(),
+            seed_names.size(), n_lines,           bytes_read};
+  }
+
+  // Drops the records and the names appended since m was taken, e.g. to
+  // undo an append_file.
+  void truncate(const Mark& m) {
+    own();
+    b_inst_names.truncate(m.n_inst_names);
+    b_alg_names.truncate(m.n_alg_names);
+    b_seed_names.truncate(m.n_seed_names);
+    b_rec_inst.resize(m.n_records);
+    b_rec_alg.resize(m.n_records);
+    b_rec_seed.resize(m.n_records);
+    b_rec_limit.resize(m.n_records);
+    b_rec_objective.resize(m.n_records);
+    b_rec_time.resize(m.n_records);
+    b_rec_hist_begin.resize(m.n_records + 1);
+    std::uint64_t n_history = b_rec_hist_begin.back();
+    b_hist_value.resize(n_history);
+    b_hist_time.resize(n_history);
+    b_hist_time_value.resize(n_history);
+    n_lines = m.n_lines;
+    bytes_read = m.bytes_read;
+    point_to_builders();
+  }
+
+  //-----------------------------------------------------------------
+  // Writes the archive as a binary cache of the text file source.  The file
+  // is first written under a temporary name and then renamed, so that a
+  // partially written cache is never picked up.
+  bool write_cache(const std::string& filename,
+                   const std::string& source) const {
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.endian = kEndian;
+    if (!source_stat(source, header.source_size, header.source_mtime_ns))
+      return false;
+    header.n_records = n_records();
+    header.n_history = hist_time_value.size;
+    header.n_lines = n_lines;
+    header.names_present = names_present;
+    header.names_size = names_size;
+    header.names_mtime_ns = names_mtime_ns;
+
+    const void* data[kSections];
+    data[kInstNameOff] = inst_names.off.data;
+    data[kInstNameChars] = inst_names.chars.data;
+    data[kAlgNameOff] = alg_names.off.data;
+    data[kAlgNameChars] = alg_names.chars.data;
+    data[kSeedNameOff] = seed_names.off.data;
+    data[kSeedNameChars] = seed_names.chars.data;
+    data[kRecInst] = rec_inst.data;
+    data[kRecAlg] = rec_alg.data;
+    data[kRecSeed] = rec_seed.data;
+    data[kRecLimit] = rec_limit.data;
+    data[kRecObjective] = rec_objective.data;
+    data[kRecTime] = rec_time.data;
+    data[kRecHistBegin] = rec_hist_begin.data;
+    data[kHistValue] = hist_value.data;
+    data[kHistTime] = hist_time.data;
+    data[kHistTimeValue] = hist_time_value.data;
+    data[kDisplayKeyOff] = display_keys.off.data;
+    data[kDisplayKeyChars] = display_keys.chars.data;
+    data[kDisplayValueOff] = display_values.off.data;
+    data[kDisplayValueChars] = display_values.chars.data;
+    data[kDisplaySource] = names_source.data();
+    std::uint64_t expected[kSections];
+    section_sizes(header, expected);
+    // the sizes of the name and character sections are not implied by the
+    // counts in the header
+    expected[kInstNameOff] = inst_names.off.size * sizeof(std::uint64_t);
+    expected[kAlgNameOff] = alg_names.off.size * sizeof(std::uint64_t);
+    expected[kSeedNameOff] = seed_names.off.size * sizeof(std::uint64_t);
+    expected[kInstNameChars] = inst_names.chars.size;
+    expected[kAlgNameChars] = alg_names.chars.size;
+    expected[kSeedNameChars] = seed_names.chars.size;
+    expected[kDisplayKeyOff] = display_keys.off.size * sizeof(std::uint64_t);
+    expected[kDisplayValueOff] =
+        display_values.off.size * sizeof(std::uint64_t);
+    expected[kDisplayKeyChars] = display_keys.chars.size;
+    expected[kDisplayValueChars] = display_values.chars.size;
+    expected[kDisplaySource] = names_source.size();
+
+    std::copy(expected, expected + kSections, header.section_size);
+    layout_sections(sizeof(header), kSections, header.section_size,
+                    header.section_offset);
+    return write_sections(filename, &header, sizeof(header), kSections, data,
+                          header.section_offset, header.section_size);
+  }
+
+  //-----------------------------------------------------------------
+  // Maps the binary cache filename, provided it is a valid cache and it is
+  // fresh with respect to the text file source, i.e. source has not been
+  // modified since the cache was compiled.  If source does not exist the
+  // cache is used as is.  Returns false (and leaves the archive empty) if
+  // the cache cannot be used.
+  bool map_cache(const std::string& filename, const std::string& source) {
+    unmap();
+    if (!mapped.map(filename, sizeof(CacheHeader))) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, mapped.data(), sizeof(header));
+    std::uint64_t size;
+    std::int64_t mtime;
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kVersion && header.endian == kEndian;
+    if (valid && source_stat(source, size, mtime))
+      valid = size == header.source_size && mtime == header.source_mtime_ns;
+    valid = valid && sections_within(kSections, header.section_offset,
+                                     header.section_size, mapped.size());
+    std::uint64_t expected[kSections];
+    if (valid) {
+      section_sizes(header, expected);
+      for (int s = 0; s != kSections && valid; ++s)
+        valid = expected[s] == kCharsSection ||
+                header.section_size[s] == expected[s];
+    }
+    for (int s : {kInstNameOff, kAlgNameOff, kSeedNameOff, kDisplayKeyOff,
+                  kDisplayValueOff})
+      valid = valid && header.section_size[s] >= sizeof(std::uint64_t) &&
+              header.section_size[s] % sizeof(std::uint64_t) == 0;
+    if (!valid) {
+      unmap();
+      return false;
+    }
+
+    auto section = [&](int s) {
+      return mapped.data() + header.section_offset[s];
+    };
+    auto strings = [&](int s_off, int s_chars, std::uint64_t n) {
+      return StringColumn{
+          {reinterpret_cast<const std::uint64_t*>(section(s_off)), n + 1},
+          {section(s_chars), header.section_size[s_chars]}};
+    };
+    std::uint64_t R = header.n_records;
+    std::uint64_t H = header.n_history;
+    inst_names = strings(kInstNameOff, kInstNameChars,
+                         header.section_size[kInstNameOff] / 8 - 1);
+    alg_names = strings(kAlgNameOff, kAlgNameChars,
+                        header.section_size[kAlgNameOff] / 8 - 1);
+    seed_names = strings(kSeedNameOff, kSeedNameChars,
+                         header.section_size[kSeedNameOff] / 8 - 1);
+    rec_inst = {reinterpret_cast<const std::uint32_t*>(section(kRecInst)), R};
+    rec_alg = {reinterpret_cast<const std::uint32_t*>(section(kRecAlg)), R};
+    rec_seed = {reinterpret_cast<const std::uint32_t*>(section(kRecSeed)), R};
+    rec_limit = {reinterpret_cast<const double*>(section(kRecLimit)), R};
+    rec_objective = {reinterpret_cast<const Decimal*>(section(kRecObjective)),
+                     R};
+    rec_time = {reinterpret_cast<const Decimal*>(section(kRecTime)), R};
+    rec_hist_begin = {
+        reinterpret_cast<const std::uint64_t*>(section(kRecHistBegin)), R + 1};
+    hist_value = {reinterpret_cast<const Decimal*>(section(kHistValue)), H};
+    hist_time = {reinterpret_cast<const Decimal*>(section(kHistTime)), H};
+    hist_time_value = {
+        reinterpret_cast<const double*>(section(kHistTimeValue)), H};
+    n_lines = header.n_lines;
+    display_keys = strings(kDisplayKeyOff, kDisplayKeyChars,
+                           header.section_size[kDisplayKeyOff] / 8 - 1);
+    display_values = strings(kDisplayValueOff, kDisplayValueChars,
+                             header.section_size[kDisplayValueOff] / 8 - 1);
+    names_present = header.names_present != 0;
+    names_size = header.names_size;
+    names_mtime_ns = header.names_mtime_ns;
+    names_source.assign(section(kDisplaySource),
+                        header.section_size[kDisplaySource]);
+
+    // every name and every history must be within the mapped file; the
+    // records must name existing instances, algorithms and seeds
+    auto below = [](const ArrayView<std::uint32_t>& ids, std::size_t n) {
+      return std::all_of(ids.data, ids.data + ids.size,
+                         [n](std::uint32_t id) { return id < n; });
+    };
+    for (const StringColumn* c :
+         {&inst_names, &alg_names, &seed_names, &display_keys, &display_values})
+      valid = valid && c->valid();
+    valid = valid && display_keys.size() == display_values.size();
+    valid = valid && rec_hist_begin[R] == H &&
+            std::is_sorted(rec_hist_begin.data,
+                           rec_hist_begin.data + rec_hist_begin.size);
+    valid = valid && below(rec_inst, inst_names.size()) &&
+            below(rec_alg, alg_names.size()) &&
+            below(rec_seed, seed_names.size());
+    if (!valid) {
+      unmap();
+      return false;
+    }
+    bytes_read = mapped.size();
+    return true;
+  }
+
+ private:
+  static constexpr char kMagic[8] = {'T', 'G', 'R', 'E', 'S', 'U', 'L', 'T'};
+  static constexpr std::uint32_t kEndian = 0x01020304;
+  // marks, in section_sizes, the sections whose size is not implied by the
+  // counts in the header
+  static constexpr std::uint64_t kCharsSection =
+      std::numeric_limits<std::uint64_t>::max();
+
+  // owned storage, used when the archive is parsed from the text file
+  StringInterner b_inst_names, b_alg_names, b_seed_names;
+  std::vector<std::uint32_t> b_rec_inst, b_rec_alg, b_rec_seed;
+  std::vector<double> b_rec_limit;
+  std::vector<Decimal> b_rec_objective, b_rec_time;
+  std::vector<std::uint64_t> b_rec_hist_begin{0};
+  std::vector<Decimal> b_hist_value, b_hist_time;
+  std::vector<double> b_hist_time_value;
+  StringColumnBuilder b_display_keys, b_display_values;
+
+  // first invalid number met while parsing
+  bool failed = false;
+  std::uint64_t error_line = 0;
+  std::string error_text;
+
+  // file the display names were read from
+  bool names_present = false;
+  std::string names_source;
+  std::uint64_t names_size = 0;
+  std::int64_t names_mtime_ns = 0;
+
+  // mapped cache file, if any
+  MappedFile mapped;
+
+  // Sizes in bytes of the sections implied by the counts in the header.
+  static void section_sizes(const CacheHeader& h, std::uint64_t* size) {
+    std::uint64_t R = h.n_records;
+    std::uint64_t H = h.n_history;
+    for (int s = 0; s != kSections; ++s) size[s] = kCharsSection;
+    // the number of names is only known through the size of their offsets
+    size[kInstNameOff] = h.section_size[kInstNameOff];
+    size[kAlgNameOff] = h.section_size[kAlgNameOff];
+    size[kSeedNameOff] = h.section_size[kSeedNameOff];
+    size[kDisplayKeyOff] = h.section_size[kDisplayKeyOff];
+    size[kDisplayValueOff] = h.section_size[kDisplayValueOff];
+    size[kRecInst] = R * sizeof(std::uint32_t);
+    size[kRecAlg] = R * sizeof(std::uint32_t);
+    size[kRecSeed] = R * sizeof(std::uint32_t);
+    size[kRecLimit] = R * sizeof(double);
+    size[kRecObjective] = R * sizeof(Decimal);
+    size[kRecTime] = R * sizeof(Decimal);
+    size[kRecHistBegin] = (R + 1) * sizeof(std::uint64_t);
+    size[kHistValue] = H * sizeof(Decimal);
+    size[kHistTime] = H * sizeof(Decimal);
+    size[kHistTimeValue] = H * sizeof(double);
+  }
+
+  // Smallest chunk of the results file worth a thread of its own.
+  static constexpr std::size_t kMinChunk = 1 << 20;
+
+  // Splits [begin, end) into at most n chunks of whole lines and of about
+  // the same size.  Returns the boundaries of the chunks, begin and end
+  // included.
+  static std::vector<const char*> split_lines(const char* begin,
+                                              const char* end, unsigned n) {
+    std::size_t len = end - begin;
+    std::size_t nchunks = std::min<std::size_t>(n, len / kMinChunk);
+    if (nchunks == 0) nchunks = 1;
+    std::vector<const char*> bounds{begin};
+    for (std::size_t k = 1; k < nchunks; ++k) {
+      // the chunk starts after the first newline at or after its nominal
+      // beginning minus one, i.e. at the beginning of a line
+      const char* p = std::max(begin + len / nchunks * k, bounds.back());
+      if (p == begin) continue;
+      const char* nl = static_cast<const char*>(
+          std::memchr(p - 1, '\n', end - (p - 1)));
+      bounds.push_back(nl == nullptr ? end : nl + 1);
+    }
+    bounds.push_back(end);
+    return bounds;
+  }
+
+  // Parses the data lines in [begin, end) and appends them to the builders.
+  // Returns false, leaving the description of the error in error_line and
+  // error_text, at the first line with an invalid number.
+  bool parse_lines(const char* begin, const char* end) {
+    while (begin < end) {
+      const char* nl =
+          static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+      const char* line_end = nl == nullptr ? end : nl;
+      ++n_lines;
+      if (line_end != begin &&
+          !parse_line(std::string_view(begin, line_end - begin)))
+        return false;
+      begin = nl == nullptr ? end : nl + 1;
+    }
+    return true;
+  }
+
+  // Parses one data line and appends it to the builders.  Fields after the
+  // history are ignored and missing ones are taken as empty.
+  bool parse_line(std::string_view line) {
+    FieldReader fields(line);
+    std::string_view token;
+    std::uint32_t Inst = 0, Algo = 0, Seed = 0;
+    double limit = 0.0;
+    Decimal Value, Time;
+    for (int Ind = 0; Ind <= 7 && fields.next(token); ++Ind) {
+      switch (Ind) {
+        case 0:  // timestamp
+          break;
+        case 1:  // graphname
+          Inst = b_inst_names.intern(token);
+          break;
+        case 2:  // algorithm
+          Algo = b_alg_names.intern(token);
+          break;
+        case 3:  // seed
+          Seed = b_seed_names.intern(token);
+          break;
+        case 4:  // time limit
+          limit = parse_double(token);
+          break;
+        case 5:  // objective
+          if (!to_decimal(token, Value)) return false;
+          break;
+        case 6:  // time
+          if (!to_decimal(token, Time)) return false;
+          break;
+        case 7:  // history
+          if (!split_history(token, Value, Time)) return false;
+          break;
+      }
+    }
+    b_rec_inst.push_back(Inst);
+    b_rec_alg.push_back(Algo);
+    b_rec_seed.push_back(Seed);
+    b_rec_limit.push_back(limit);
+    b_rec_objective.push_back(Value);
+    b_rec_time.push_back(Time);
+    b_rec_hist_begin.push_back(b_hist_time_value.size());
+    return true;
+  }
+
+  // Appends the records of part, which was parsed from the lines following
+  // the ones already in the builders, mapping its names to the ids of the
+  // builders.
+  void append(const ResultsArchive& part) {
+    auto remap = [](StringInterner& names, const StringInterner& part_names,
+                    const std::vector<std::uint32_t>& part_ids,
+                    std::vector<std::uint32_t>& out) {
+      std::vector<std::uint32_t> id(part_names.size());
+      for (std::size_t k = 0; k != part_names.size(); ++k)
+        id[k] = names.intern(part_names[k]);
+      for (std::uint32_t k : part_ids) out.push_back(id[k]);
+    };
+    remap(b_inst_names, part.b_inst_names, part.b_rec_inst, b_rec_inst);
+    remap(b_alg_names, part.b_alg_names, part.b_rec_alg, b_rec_alg);
+    remap(b_seed_names, part.b_seed_names, part.b_rec_seed, b_rec_seed);
+    auto concat = [](auto& out, const auto& in) {
+      out.insert(out.end(), in.begin(), in.end());
+    };
+    concat(b_rec_limit, part.b_rec_limit);
+    concat(b_rec_objective, part.b_rec_objective);
+    concat(b_rec_time, part.b_rec_time);
+    std::uint64_t shift = b_hist_time_value.size();
+    for (std::size_t r = 1; r < part.b_rec_hist_begin.size(); ++r)
+      b_rec_hist_begin.push_back(shift + part.b_rec_hist_begin[r]);
+    concat(b_hist_value, part.b_hist_value);
+    concat(b_hist_time, part.b_hist_time);
+    concat(b_hist_time_value, part.b_hist_time_value);
+    n_lines += part.n_lines;
+  }
+
+  // Splits a history string into its value-time pairs and appends them to
+  // the history columns in the order they appear in str.  The string is
+  // walked from the end, ignoring its last character (the trailing ';'), and
+  // the pair at its very beginning loses its first character (the leading
+  // ';' of the history).  A pair whose value becomes empty in this way
+  // stands for the objective and time of the record.  The pairs are
+  // appended as they are met and then reversed in place.
+  bool split_history(std::string_view str, const Decimal& objective,
+                     const Decimal& time) {
+    const char delimiter = ';';  // Delimiter for separating value-time pairs
+    const char separator = ':';  // Separator for value and time within a pair
+    std::size_t first = b_hist_time_value.size();
+    for (long pos = static_cast<long>(str.size()) - 2; pos > 0;) {
+      std::size_t found = str.rfind(delimiter, pos);
+      long new_pos = found == std::string_view::npos ? 0 : found;
+      std::string_view token = str.substr(new_pos + 1, pos - new_pos);
+      std::size_t colon = token.find(separator);
+      std::string_view value = token.substr(0, colon);
+      std::string_view t =
+          colon == std::string_view::npos ? token : token.substr(colon + 1);
+      if (value.empty()) {
+        b_hist_value.push_back(objective);
+        b_hist_time.push_back(time);
+      } else {
+        // the pairs are walked backwards: the error recorded last is the
+        // first one in the line
+        Decimal v, d;
+        to_decimal(t, d);
+        to_decimal(value, v);
+        b_hist_value.push_back(v);
+        b_hist_time.push_back(d);
+      }
+      b_hist_time_value.push_back(parse_double(t));
+      pos = new_pos - 1;
+    }
+    std::reverse(b_hist_value.begin() + first, b_hist_value.end());
+    std::reverse(b_hist_time.begin() + first, b_hist_time.end());
+    std::reverse(b_hist_time_value.begin() + first, b_hist_time_value.end());
+    return !failed;
+  }
+
+  // Converts a number of the current line, or records the error.
+  bool to_decimal(std::string_view s, Decimal& d) {
+    if (d.parse(s)) return true;
+    failed = true;
+    error_line = n_lines;
+    error_text = s;
+    return false;
+  }
+
+  // The error recorded by parse_lines; the lines of the results file
+  // before the ones parsed are line_offset.
+  std::string error_message(std::uint64_t line_offset) const {
+    return "Error at line " + std::to_string(line_offset + error_line + 1) +
+           ") invalid number " + error_text;
+  }
+
+  // Exits with the error recorded by parse_lines.
+  [[noreturn]] void report_error(std::uint64_t line_offset) const {
+    std::cerr << error_message(line_offset) << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  void clear_builders() {
+    unmap();
+    b_inst_names.clear();
+    b_alg_names.clear();
+    b_seed_names.clear();
+    b_display_keys = b_display_values = StringColumnBuilder();
+    names_present = false;
+    b_rec_inst.clear();
+    b_rec_alg.clear();
+    b_rec_seed.clear();
+    b_rec_limit.clear();
+    b_rec_objective.clear();
+    b_rec_time.clear();
+    b_rec_hist_begin.assign(1, 0);
+    b_hist_value.clear();
+    b_hist_time.clear();
+    b_hist_time_value.clear();
+    failed = false;
+    n_lines = 0;
+  }
+
+  // Copies the mapped cache, if any, into the builders, so that records can
+  // be appended to them.
+  void own() {
+    if (!mapped.mapped()) return;
+    auto copy = [](auto& out, const auto& view) {
+      out.assign(view.data, view.data + view.size);
+    };
+    b_inst_names.assign(inst_names);
+    b_alg_names.assign(alg_names);
+    b_seed_names.assign(seed_names);
+    copy(b_rec_inst, rec_inst);
+    copy(b_rec_alg, rec_alg);
+    copy(b_rec_seed, rec_seed);
+    copy(b_rec_limit, rec_limit);
+    copy(b_rec_objective, rec_objective);
+    copy(b_rec_time, rec_time);
+    copy(b_rec_hist_begin, rec_hist_begin);
+    copy(b_hist_value, hist_value);
+    copy(b_hist_time, hist_time);
+    copy(b_hist_time_value, hist_time_value);
+    copy(b_display_keys.off, display_keys.off);
+    copy(b_display_keys.chars, display_keys.chars);
+    copy(b_display_values.off, display_values.off);
+    copy(b_display_values.chars, display_values.chars);
+    unmap();
+    point_to_builders();
+  }
+
+  void point_to_builders() {
+    inst_names = b_inst_names.view();
+    alg_names = b_alg_names.view();
+    seed_names = b_seed_names.view();
+    rec_inst = {b_rec_inst.data(), b_rec_inst.size()};
+    rec_alg = {b_rec_alg.data(), b_rec_alg.size()};
+    rec_seed = {b_rec_seed.data(), b_rec_seed.size()};
+    rec_limit = {b_rec_limit.data(), b_rec_limit.size()};
+    rec_objective = {b_rec_objective.data(), b_rec_objective.size()};
+    rec_time = {b_rec_time.data(), b_rec_time.size()};
+    rec_hist_begin = {b_rec_hist_begin.data(), b_rec_hist_begin.size()};
+    hist_value = {b_hist_value.data(), b_hist_value.size()};
+    hist_time = {b_hist_time.data(), b_hist_time.size()};
+    hist_time_value = {b_hist_time_value.data(), b_hist_time_value.size()};
+    display_keys = b_display_keys.view();
+    display_values = b_display_values.view();
+  }
+
+  void unmap() { mapped.unmap(); }
+};
+
+//-------------------------------------------------------------------
+// Reads a text results file in a single pass by chunks of whole lines of
+// about kChunk bytes, every chunk being parsed into an archive of its own
+// (see ResultsArchive::parse_chunk), so that the memory used does not
+// depend on the size of the file.  Names are interned within every chunk
+// only.
+class ResultsStream {
+ public:
+  static constexpr std::size_t kChunk = 1 << 22;
+
+  std::uint64_t bytes_read = 0;  // bytes of the file read so far
+  std::uint64_t n_lines = 0;     // data lines parsed so far
+
+  // Opens the results file filename.  Returns false if it cannot be opened.
+  bool open(const std::string& filename) {
+    in.open(filename, std::ios::binary);
+    buffer.resize(kChunk);
+    filled = 0;
+    header = true;
+    bytes_read = n_lines = 0;
+    return in.is_open();
+  }
+
+  // Parses the next chunk of the file into chunk.  Returns false, leaving
+  // chunk empty, at the end of the file.
+  bool next(ResultsArchive& chunk) {
+    for (;;) {
+      bool eof = !in.good();
+      if (!eof && filled < buffer.size()) {
+        in.read(buffer.data() + filled, buffer.size() - filled);
+        filled += in.gcount();
+        bytes_read += in.gcount();
+        eof = !in.good();
+      }
+      const char* begin = buffer.data();
+      const char* end = begin + filled;
+      const char* last = end;  // end of the whole lines of the buffer
+      if (!eof) {
+        const char* nl = static_cast<const char*>(memrchr(begin, '\n', filled));
+        last = nl == nullptr ? nullptr : nl + 1;
+      }
+      if (last == nullptr) {
+        // a line longer than the buffer
+        buffer.resize(2 * buffer.size());
+        continue;
+      }
+      if (header) {
+        // the first line of the file is the header, which we skip
+        const char* nl = static_cast<const char*>(
+            std::memchr(begin, '\n', last - begin));
+        if (nl == nullptr && !eof) {
+          buffer.resize(2 * buffer.size());
+          continue;
+        }
+        begin = nl == nullptr ? last : nl + 1;
+        header = false;
+      }
+      if (begin == last && eof) {
+        chunk.parse_chunk(begin, begin, n_lines);
+        filled = 0;
+        return false;
+      }
+      chunk.parse_chunk(begin, last, n_lines);
+      n_lines += chunk.n_lines;
+      filled = end - last;
+      std::memmove(buffer.data(), last, filled);
+      if (chunk.n_lines > 0 || eof) return true;
+    }
+  }
+
+ private:
+  std::ifstream in;
+  std::vector<char> buffer;
+  std::size_t filled = 0;  // bytes of buffer holding the file
+  bool header = true;      // the header line is still to be skipped
+};
+
+#endif  // RESULTS_ARCHIVE_H
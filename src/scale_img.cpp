@@ -10,6 +10,15 @@
  * and rounds it to the nearest integer. It then outputs the graph with these
  * scaled integer weights.
  *
+ * The edges are streamed: each one is written as soon as it is read, through
+ * the buffered reader and writer of edge_io.h, so that memory is constant.
+ *
+ * Options:
+ *   -b: the input graph is in the binary format of edge_io.h.
+ *   -B: the output graph is written in the binary format of edge_io.h, with
+ *       int64 weights.
+ *   -h: print the usage.
+ *
  * Input Format:
  *   The input is read from standard input (std::cin).
  *   - The first line contains two integers: n (number of nodes) and m (number
@@ -40,56 +49,50 @@
  *   2 3 -50000000
  *   1 3 80000000
  */
-#include <iostream>
 #include <cmath>
-#include <limits>
+#include <cstdlib>
+#include <iostream>
 
-using namespace std;
+#include "edge_io.h"
 
-// Function to skip comment lines or lines with only spaces in an input stream.
-// Comments start with '#' and extend to the end of the line.
-void skipComment(istream& f) {
-  char ch;  // Temporary character to hold the read char
-  // Read characters until a non-comment/non-space character is encountered or
-  // the end of the stream is reached.
-  while (f.get(ch) && (ch == '#' || ch == ' ')) {
-    // Ignore all characters until the end of the line.
-    f.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-  }
-  // If a non-comment/non-space character was found, put it back into the
-  // stream.
-  if (f.good()) {
-    f.unget();
-  }
-}
+using namespace std;
 
-int main() {
+int main(int argc, char** argv) {
   int n, m, i, j;   // n: Number of nodes, m: Number of edges, i, j: Node indices
   double w;         // w: Weight of an edge (floating-point)
   long long int W;  // W: Scaled weight of an edge (integer)
+  bool in_binary, out_binary;
+  parse_format_options(argc, argv, true, in_binary, out_binary);
+  try {
+    GraphInput in(in_binary);     // the standard input
+    GraphOutput out(out_binary);  // the standard output
 
-  skipComment(std::cin);  // Skip any leading comments or blank lines in the
-                          // standard input
+    in.skip_comments('#');  // Skip any leading comments or blank lines in the
+                            // standard input
 
-  // Read the number of nodes (n) and edges (m) from the standard input.
-  cin >> n >> m;
+    // Read the number of nodes (n) and edges (m) from the standard input.
+    in.read_header(n, m);
 
-  // Output the number of nodes and edges to the standard output.
-  cout << n << " " << m << endl;
+    // Output the number of nodes and edges to the standard output.
+    out.write_header(n, m, kWeightInt64);
 
-  // Iterate through each of the 'm' edges.
-  for (int k = 0; k != m; ++k) {
-    // Read the source node (i), destination node (j), and weight (w) of the edge.
-    cin >> i >> j >> w;
+    // Iterate through each of the 'm' edges.
+    for (int k = 0; k != m; ++k) {
+      // Read the source node (i), destination node (j), and weight (w) of the edge.
+      in.read_edge(i, j, w);
 
-    // Scale the weight 'w' by 1.0e8 (100,000,000) and round it to the nearest integer.
-    // This effectively converts a floating-point weight to a fixed-point representation
-    // with 8 decimal places of precision.
-    W = round(w * 1.0e8);
+      // Scale the weight 'w' by 1.0e8 (100,000,000) and round it to the nearest integer.
+      // This effectively converts a floating-point weight to a fixed-point representation
+      // with 8 decimal places of precision.
+      W = round(w * 1.0e8);
 
-    // Output the source node (i), destination node (j), and the scaled weight (W) to the standard output.
-    cout << i << " " << j << " " << W << endl;
+      // Output the source node (i), destination node (j), and the scaled weight (W) to the standard output.
+      out.write_edge(i, j, W);
+    }
+  } catch (const GraphError& e) {
+    cerr << "Error: " << e.what() << endl;
+    exit(EXIT_FAILURE);
   }
- 
+
   return EXIT_SUCCESS;
 }
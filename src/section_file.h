@@ -0,0 +1,143 @@
+/**
+ * @file section_file.h
+ * @brief Writing and mapping of the binary files made of a header and of
+ * aligned sections: the cache of the results (results_archive.h), the
+ * index of the summary file (summary_index.h) and the index of the best
+ * known values (best_known.h).
+ *
+ * Such a file starts with a fixed size header, which records the offset
+ * and the size of every section, followed by the sections, each aligned to
+ * kSectionAlignment bytes and padded with zeros.  All integers are in
+ * native byte order.  The header also records the size and modification
+ * time of the file the binary file was computed from (see source_stat), so
+ * that a stale one is not used.
+**/
+
+#ifndef SECTION_FILE_H
+#define SECTION_FILE_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+constexpr std::size_t kSectionAlignment = 64;
+
+inline std::uint64_t align_section(std::uint64_t offset) {
+  return (offset + kSectionAlignment - 1) / kSectionAlignment *
+         kSectionAlignment;
+}
+
+// The size and modification time of file source.  Returns false if it does
+// not exist.
+inline bool source_stat(const std::string& source, std::uint64_t& size,
+                        std::int64_t& mtime_ns) {
+  struct stat st;
+  if (stat(source.c_str(), &st) != 0) return false;
+  size = st.st_size;
+  mtime_ns = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+             st.st_mtim.tv_nsec;
+  return true;
+}
+
+// Sets the offsets of the n sections of the given sizes, laid out in order
+// after a header of header_size bytes.
+inline void layout_sections(std::size_t header_size, int n,
+                            const std::uint64_t* size, std::uint64_t* offset) {
+  std::uint64_t next = align_section(header_size);
+  for (int s = 0; s != n; ++s) {
+    offset[s] = next;
+    next = align_section(next + size[s]);
+  }
+}
+
+// Writes the header and the n sections data[s], laid out as by
+// layout_sections, to filename.  The file is first written under a
+// temporary name and then renamed, so that a partially written file is
+// never picked up.  Returns false if it cannot be written.
+inline bool write_sections(const std::string& filename, const void* header,
+                           std::size_t header_size, int n,
+                           const void* const* data,
+                           const std::uint64_t* offset,
+                           const std::uint64_t* size) {
+  std::string tmpname = filename + ".tmp";
+  std::ofstream fout(tmpname, std::ios::binary | std::ios::trunc);
+  if (!fout.is_open()) return false;
+  const char zeros[kSectionAlignment] = {};
+  fout.write(static_cast<const char*>(header), header_size);
+  std::uint64_t written = header_size;
+  for (int s = 0; s != n; ++s) {
+    fout.write(zeros, offset[s] - written);
+    fout.write(static_cast<const char*>(data[s]), size[s]);
+    written = offset[s] + size[s];
+  }
+  fout.close();
+  if (!fout || std::rename(tmpname.c_str(), filename.c_str()) != 0) {
+    std::remove(tmpname.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Whether the n sections recorded in a header are aligned and within a
+// file of file_size bytes.
+inline bool sections_within(int n, const std::uint64_t* offset,
+                            const std::uint64_t* size,
+                            std::uint64_t file_size) {
+  for (int s = 0; s != n; ++s)
+    if (offset[s] % kSectionAlignment != 0 || offset[s] > file_size ||
+        size[s] > file_size - offset[s])
+      return false;
+  return true;
+}
+
+//-------------------------------------------------------------------
+// A file mapped read-only in memory.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() { unmap(); }
+
+  const char* data() const { return addr; }
+  std::size_t size() const { return length; }
+  bool mapped() const { return addr != nullptr; }
+
+  // Maps filename.  Returns false, with nothing mapped, if it cannot be
+  // mapped or is smaller than min_size bytes.
+  bool map(const std::string& filename, std::size_t min_size) {
+    unmap();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<std::size_t>(st.st_size) < min_size || st.st_size == 0) {
+      close(fd);
+      return false;
+    }
+    void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    addr = static_cast<const char*>(p);
+    length = st.st_size;
+    return true;
+  }
+
+  void unmap() {
+    if (addr != nullptr) munmap(const_cast<char*>(addr), length);
+    addr = nullptr;
+    length = 0;
+  }
+
+ private:
+  const char* addr = nullptr;
+  std::size_t length = 0;
+};
+
+#endif  // SECTION_FILE_H
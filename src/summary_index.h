@@ -0,0 +1,544 @@
+/**
+ * @file summary_index.h
+ * @brief Compiled, memory-mappable form of the instance summary file, and
+ * predicates over its columns.
+ *
+ * The summary file is a CSV with a header line and one row per instance:
+ *   name,n,m,density,max_deg,mean_deg,sd_deg,n_neg,n_zero,n_pos,
+ *   max_precision,mean_w,sd_w,interesting,toroidal
+ * A SummaryIndex holds the same information in columnar form: the names,
+ * and for every other column a plain array of doubles with its value for
+ * every instance (the integer columns are exactly represented).  Like the
+ * results archive (see results_archive.h), it is either built by parsing the
+ * text file or mapped in memory from a binary index written by a previous
+ * compilation, in which case no parsing takes place.
+ *
+ * Binary index layout (all integers in native byte order, see
+ * section_file.h): a fixed size IndexHeader, with the size and modification
+ * time of the summary file it was compiled from, followed by kSections
+ * sections aligned to kSectionAlignment bytes: the offsets and the
+ * characters of the names, then one section per numeric column.
+ *
+ * A SummaryPredicate is an expression over the columns, e.g.
+ *   n >= 100 && n <= 1000 && (density < 0.1 || toroidal == 1)
+ * made of the column names, numbers, the arithmetic operators + - * / and
+ * unary -, the comparisons < <= > >= == !=, the logical operators ! && ||
+ * and parentheses, with the precedence of C++.  Comparisons and logical
+ * operators give 1 (true) or 0 (false); an instance satisfies a predicate
+ * whose value is not 0.  Predicates are evaluated column-wise: every node
+ * of the expression computes its value for all instances in a simple loop
+ * over arrays, which the compiler vectorizes.
+**/
+
+#ifndef SUMMARY_INDEX_H
+#define SUMMARY_INDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csv.h"
+#include "results_archive.h"  // For ArrayView and the string columns
+#include "section_file.h"
+
+//-------------------------------------------------------------------
+class SummaryIndex {
+ public:
+  static constexpr std::uint32_t kVersion = 1;
+
+  // The numeric columns, in the order of the summary file.
+  enum Column {
+    kN,
+    kM,
+    kDensity,
+    kMaxDeg,
+    kMeanDeg,
+    kSdDeg,
+    kNNeg,
+    kNZero,
+    kNPos,
+    kMaxPrecision,
+    kMeanW,
+    kSdW,
+    kInteresting,
+    kToroidal,
+    kColumns
+  };
+  static constexpr const char* kColumnNames[kColumns] = {
+      "n", "m", "density", "max_deg", "mean_deg", "sd_deg", "n_neg", "n_zero",
+      "n_pos", "max_precision", "mean_w", "sd_w", "interesting", "toroidal"};
+  // whether the column holds integers
+  static constexpr bool kIntegral[kColumns] = {
+      true,  true,  false, true,  true,  true,  false,
+      false, false, true,  false, false, true,  true};
+
+  // Index of every section in the binary index.
+  enum Section {
+    kNameOff,
+    kNameChars,
+    kFirstColumn,  // the numeric columns follow in order
+    kSections = kFirstColumn + kColumns
+  };
+
+  struct IndexHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endian;
+    std::uint64_t source_size;
+    std::int64_t source_mtime_ns;
+    std::uint64_t n_instances;
+    std::uint64_t section_offset[kSections];
+    std::uint64_t section_size[kSections];
+  };
+
+  // Columns of the index.  They point either into the builders below or
+  // into the mapped index file.
+  StringColumn names;
+  ArrayView<double> columns[kColumns];
+
+  SummaryIndex() = default;
+  SummaryIndex(const SummaryIndex&) = delete;
+  SummaryIndex& operator=(const SummaryIndex&) = delete;
+  ~SummaryIndex() { unmap(); }
+
+  std::size_t size() const { return names.size(); }
+
+  // Name of the binary index associated to a summary file.
+  static std::string index_name(const std::string& summary) {
+    return summary + ".idx";
+  }
+
+  // The column called name, or kColumns if there is none.
+  static int find_column(std::string_view name) {
+    for (int c = 0; c != kColumns; ++c)
+      if (name == kColumnNames[c]) return c;
+    return kColumns;
+  }
+
+  //-----------------------------------------------------------------
+  // Parses the text summary file.  Returns false if it cannot be opened.
+  // The lines with too few fields or with an invalid number are reported
+  // and skipped; an empty field stands for 0.  The integer fields are
+  // converted as stoi does and stored as unsigned values.
+  bool parse(const std::string& filename) {
+    std::ifstream sumf(filename);
+    if (!sumf.is_open()) return false;
+    unmap();
+    b_names = StringColumnBuilder();
+    for (std::vector<double>& c : b_columns) c.clear();
+
+    std::string line;
+    std::getline(sumf, line);  // skip header line
+    std::string_view tokens[kColumns + 1];
+    double values[kColumns];
+    while (std::getline(sumf, line)) {
+      // Split the line into its first kColumns + 1 tokens
+      FieldReader fields(line);
+      int n_tokens = 0;
+      while (n_tokens != kColumns + 1 && fields.next(tokens[n_tokens]))
+        ++n_tokens;
+      if (n_tokens < kColumns + 1) {
+        std::cerr << "Error: Invalid line format: " << line << std::endl;
+        continue;  // skip to next line
+      }
+      bool valid = true;
+      for (int c = 0; c != kColumns && valid; ++c)
+        valid = to_value(tokens[c + 1], kIntegral[c], values[c]);
+      if (!valid) {
+        std::cerr << "Error: Invalid number in line: " << line << std::endl;
+        continue;  // skip to next line
+      }
+      b_names.push_back(tokens[0]);
+      for (int c = 0; c != kColumns; ++c) b_columns[c].push_back(values[c]);
+    }
+    point_to_builders();
+    return true;
+  }
+
+  //-----------------------------------------------------------------
+  // Writes the index as a binary index of the summary file source, under a
+  // temporary name first, as ResultsArchive::write_cache.
+  bool write_index(const std::string& filename,
+                   const std::string& source) const {
+    IndexHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.endian = kEndian;
+    if (!source_stat(source, header.source_size, header.source_mtime_ns))
+      return false;
+    header.n_instances = size();
+
+    const void* data[kSections];
+    data[kNameOff] = names.off.data;
+    data[kNameChars] = names.chars.data;
+    header.section_size[kNameOff] = names.off.size * sizeof(std::uint64_t);
+    header.section_size[kNameChars] = names.chars.size;
+    for (int c = 0; c != kColumns; ++c) {
+      data[kFirstColumn + c] = columns[c].data;
+      header.section_size[kFirstColumn + c] = size() * sizeof(double);
+    }
+    layout_sections(sizeof(header), kSections, header.section_size,
+                    header.section_offset);
+    return write_sections(filename, &header, sizeof(header), kSections, data,
+                          header.section_offset, header.section_size);
+  }
+
+  //-----------------------------------------------------------------
+  // Maps the binary index filename, provided it is a valid index and it is
+  // fresh with respect to the summary file source.  If source does not
+  // exist the index is used as is.  Returns false (and leaves the index
+  // empty) if it cannot be used.
+  bool map_index(const std::string& filename, const std::string& source) {
+    unmap();
+    if (!mapped.map(filename, sizeof(IndexHeader))) return false;
+
+    IndexHeader header;
+    std::memcpy(&header, mapped.data(), sizeof(header));
+    std::uint64_t size;
+    std::int64_t mtime;
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(header.magic)) == 0 &&
+                 header.version == kVersion && header.endian == kEndian;
+    if (valid && source_stat(source, size, mtime))
+      valid = size == header.source_size && mtime == header.source_mtime_ns;
+    valid = valid && sections_within(kSections, header.section_offset,
+                                     header.section_size, mapped.size());
+    std::uint64_t N = header.n_instances;
+    for (int s = 0; s != kSections && valid; ++s) {
+      std::uint64_t expected = s == kNameOff ? (N + 1) * sizeof(std::uint64_t)
+                               : s == kNameChars ? header.section_size[s]
+                                                 : N * sizeof(double);
+      valid = header.section_size[s] == expected;
+    }
+    if (!valid) {
+      unmap();
+      return false;
+    }
+
+    auto section = [&](int s) {
+      return mapped.data() + header.section_offset[s];
+    };
+    names = {{reinterpret_cast<const std::uint64_t*>(section(kNameOff)), N + 1},
+             {section(kNameChars), header.section_size[kNameChars]}};
+    for (int c = 0; c != kColumns; ++c)
+      columns[c] = {reinterpret_cast<const double*>(section(kFirstColumn + c)),
+                    N};
+    if (!names.valid()) {
+      unmap();
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr char kMagic[8] = {'S', 'U', 'M', 'I', 'N', 'D', 'E', 'X'};
+  static constexpr std::uint32_t kEndian = 0x01020304;
+
+  // owned storage, used when the index is parsed from the text file
+  StringColumnBuilder b_names;
+  std::vector<double> b_columns[kColumns];
+
+  // mapped index file, if any
+  MappedFile mapped;
+
+  // Converts a field, the way stoi (as an unsigned value) or stod does; an
+  // empty field stands for 0.
+  static bool to_value(std::string_view field, bool integral, double& value) {
+    value = 0.0;
+    if (field.empty()) return true;
+    if (!integral) return parse_number(field, value);
+    int v;
+    if (!parse_number(field, v)) return false;
+    value = static_cast<unsigned int>(v);
+    return true;
+  }
+
+  void point_to_builders() {
+    names = b_names.view();
+    for (int c = 0; c != kColumns; ++c)
+      columns[c] = {b_columns[c].data(), b_columns[c].size()};
+  }
+
+  void unmap() {
+    mapped.unmap();
+    names = b_names.view();
+    for (int c = 0; c != kColumns; ++c) columns[c] = {};
+  }
+};
+
+//-------------------------------------------------------------------
+// A predicate over the columns of a SummaryIndex, compiled from its text.
+class SummaryPredicate {
+ public:
+  // Compiles text.  Returns false, with a description of the error in
+  // error, if it is not a valid predicate.
+  bool compile(const std::string& text, std::string& error) {
+    src = text;
+    pos = 0;
+    nesting = 0;
+    error.clear();
+    nodes.clear();
+    root = parse_or();
+    skip_blanks();
+    if (message.empty() && pos != src.size())
+      fail("unexpected '" + std::string(1, src[pos]) + "'");
+    error = message;
+    message.clear();
+    return error.empty();
+  }
+
+  // Evaluates the predicate on all instances of index: selected[k] is
+  // whether instance k satisfies it.
+  void evaluate(const SummaryIndex& index, std::vector<bool>& selected) const {
+    std::vector<double> value = eval(index, root);
+    selected.resize(index.size());
+    for (std::size_t k = 0; k != value.size(); ++k)
+      selected[k] = value[k] != 0.0;
+  }
+
+ private:
+  enum Op {
+    kConst, kColumn, kNeg, kNot, kAdd, kSub, kMul, kDiv,
+    kLt, kLe, kGt, kGe, kEq, kNe, kAnd, kOr
+  };
+  struct Node {
+    Op op;
+    double value;  // kConst
+    int column;    // kColumn
+    int left, right;
+    int depth;  // of the subtree, whose evaluation recurses as deep
+  };
+  std::vector<Node> nodes;
+  int root = -1;
+
+  // Limits of the parentheses and unary operators nested, each of which
+  // recurses through all the parse functions, and of the depth of the
+  // expression (e.g. of a chain of &&): beyond them, the recursion of the
+  // parser or of eval could overflow the stack.
+  static constexpr int kMaxNesting = 256;
+  static constexpr int kMaxDepth = 4096;
+
+  // parser state
+  std::string src;
+  std::size_t pos = 0;
+  int nesting = 0;      // parentheses and unary operators being parsed
+  std::string message;  // the first error
+
+  int add(Op op, int left = -1, int right = -1, double value = 0.0,
+          int column = 0) {
+    int depth = 1;
+    for (int child : {left, right})
+      if (child >= 0) depth = std::max(depth, nodes[child].depth + 1);
+    if (depth > kMaxDepth) return fail("expression nested too deeply");
+    nodes.push_back({op, value, column, left, right, depth});
+    return static_cast<int>(nodes.size()) - 1;
+  }
+
+  // Enters a parenthesis or a unary operator.  Returns false, failing, if
+  // they are nested too deeply.
+  bool enter() {
+    if (++nesting <= kMaxNesting) return true;
+    fail("expression nested too deeply");
+    return false;
+  }
+
+  int fail(const std::string& what) {
+    if (message.empty())
+      message = what + " at position " + std::to_string(pos + 1);
+    return add(kConst);
+  }
+
+  void skip_blanks() {
+    while (pos < src.size() &&
+           std::isspace(static_cast<unsigned char>(src[pos])))
+      ++pos;
+  }
+
+  // Whether the next token is s, which is then consumed.
+  bool accept(std::string_view s) {
+    skip_blanks();
+    if (src.compare(pos, s.size(), s) != 0) return false;
+    // one of < > = ! is not the beginning of <= >= == !=
+    if (s.size() == 1 && std::strchr("<>=!", s[0]) != nullptr &&
+        pos + 1 < src.size() && src[pos + 1] == '=')
+      return false;
+    pos += s.size();
+    return true;
+  }
+
+  int parse_or() {
+    int left = parse_and();
+    while (accept("||")) left = add(kOr, left, parse_and());
+    return left;
+  }
+
+  int parse_and() {
+    int left = parse_comparison();
+    while (accept("&&")) left = add(kAnd, left, parse_comparison());
+    return left;
+  }
+
+  int parse_comparison() {
+    int left = parse_sum();
+    for (;;) {
+      if (accept("<="))
+        left = add(kLe, left, parse_sum());
+      else if (accept(">="))
+        left = add(kGe, left, parse_sum());
+      else if (accept("=="))
+        left = add(kEq, left, parse_sum());
+      else if (accept("!="))
+        left = add(kNe, left, parse_sum());
+      else if (accept("<"))
+        left = add(kLt, left, parse_sum());
+      else if (accept(">"))
+        left = add(kGt, left, parse_sum());
+      else
+        return left;
+    }
+  }
+
+  int parse_sum() {
+    int left = parse_product();
+    for (;;) {
+      if (accept("+"))
+        left = add(kAdd, left, parse_product());
+      else if (accept("-"))
+        left = add(kSub, left, parse_product());
+      else
+        return left;
+    }
+  }
+
+  int parse_product() {
+    int left = parse_unary();
+    for (;;) {
+      if (accept("*"))
+        left = add(kMul, left, parse_unary());
+      else if (accept("/"))
+        left = add(kDiv, left, parse_unary());
+      else
+        return left;
+    }
+  }
+
+  int parse_unary() {
+    Op op;
+    if (accept("-"))
+      op = kNeg;
+    else if (accept("!"))
+      op = kNot;
+    else
+      return parse_primary();
+    if (!enter()) return add(kConst);
+    int e = add(op, parse_unary());
+    --nesting;
+    return e;
+  }
+
+  int parse_primary() {
+    skip_blanks();
+    if (accept("(")) {
+      if (!enter()) return add(kConst);
+      int e = parse_or();
+      --nesting;
+      if (!accept(")")) return fail("missing ')'");
+      return e;
+    }
+    if (pos == src.size()) return fail("unexpected end");
+    char c = src[pos];
+    if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+      std::size_t end = pos;
+      while (end < src.size() &&
+             (std::isalnum(static_cast<unsigned char>(src[end])) ||
+              src[end] == '_'))
+        ++end;
+      std::string_view name(src.data() + pos, end - pos);
+      int column = SummaryIndex::find_column(name);
+      if (column == SummaryIndex::kColumns)
+        return fail("unknown column '" + std::string(name) + "'");
+      pos = end;
+      return add(kColumn, -1, -1, 0.0, column);
+    }
+    double value;
+    std::from_chars_result res =
+        std::from_chars(src.data() + pos, src.data() + src.size(), value);
+    if (res.ec != std::errc()) return fail("invalid number");
+    pos = res.ptr - src.data();
+    return add(kConst, -1, -1, value);
+  }
+
+  std::vector<double> eval(const SummaryIndex& index, int k) const {
+    const Node& node = nodes[k];
+    std::size_t N = index.size();
+    std::vector<double> a;
+    if (node.op == kConst) return std::vector<double>(N, node.value);
+    if (node.op == kColumn) {
+      const ArrayView<double>& col = index.columns[node.column];
+      return std::vector<double>(col.data, col.data + col.size);
+    }
+    a = eval(index, node.left);
+    double* x = a.data();
+    if (node.op == kNeg) {
+      for (std::size_t i = 0; i != N; ++i) x[i] = -x[i];
+      return a;
+    }
+    if (node.op == kNot) {
+      for (std::size_t i = 0; i != N; ++i) x[i] = x[i] == 0.0;
+      return a;
+    }
+    std::vector<double> b = eval(index, node.right);
+    const double* y = b.data();
+    switch (node.op) {
+      case kAdd:
+        for (std::size_t i = 0; i != N; ++i) x[i] += y[i];
+        break;
+      case kSub:
+        for (std::size_t i = 0; i != N; ++i) x[i] -= y[i];
+        break;
+      case kMul:
+        for (std::size_t i = 0; i != N; ++i) x[i] *= y[i];
+        break;
+      case kDiv:
+        for (std::size_t i = 0; i != N; ++i) x[i] /= y[i];
+        break;
+      case kLt:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] < y[i];
+        break;
+      case kLe:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] <= y[i];
+        break;
+      case kGt:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] > y[i];
+        break;
+      case kGe:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] >= y[i];
+        break;
+      case kEq:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] == y[i];
+        break;
+      case kNe:
+        for (std::size_t i = 0; i != N; ++i) x[i] = x[i] != y[i];
+        break;
+      case kAnd:
+        for (std::size_t i = 0; i != N; ++i)
+          x[i] = (x[i] != 0.0) & (y[i] != 0.0);
+        break;
+      case kOr:
+        for (std::size_t i = 0; i != N; ++i)
+          x[i] = (x[i] != 0.0) | (y[i] != 0.0);
+        break;
+      default:
+        break;
+    }
+    return a;
+  }
+};
+
+#endif  // SUMMARY_INDEX_H
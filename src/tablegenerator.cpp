@@ -21,13 +21,27 @@
  *   - Average Rank (AR): The average rank of an algorithm across all instances
  *     and seeds.
  *
+ * Objective values and times are compared exactly, as decimal numbers (see
+ * decimal.h), so that ties are detected whatever their representation in the
+ * results file.
+ *
  * The program can filter the instances and algorithms to be analyzed based on
- * lists provided in separate files.
+ * lists provided in separate files, or on a predicate over the instance
+ * summary file of extract.
  * It can also scale the time limits used in the analysis.
  * The output is a CSV file containing the computed statistics for each
  * algorithm.
  * Optionally, it can also generate a file containing the names of "difficult"
- * instances, where the best result is found by a limited number of algorithms.
+ * instances, where the best result is found by a limited number of algorithms,
+ * and files with the ranks, the pairwise wins, the time-to-target profiles and
+ * the best known values, as well as bootstrap confidence intervals and the
+ * tables of several time scalings at once.
+ *
+ * The results file is parsed in parallel, or mapped from the binary cache it
+ * can be compiled into (see results_archive.h); new runs can be merged into
+ * it; it can be streamed in bounded memory; and it can be loaded once to
+ * answer queries, in server mode.  The statistics are computed in parallel,
+ * with the same outcome whatever the number of threads.
  *
  * Input:
  *   - A parameter file specifying the results file, instance and algorithm
@@ -46,7 +60,7 @@
  *   - -d <file_name>: Generates a file with "difficult" instance names.
  *   - -l <level>: Sets the difficulty level for instance selection (used with
  *        -d).
- *   - -h: Prints the help message.
+ *   - -h: Prints the help message, which describes the other options.
  *
  * Parameter file format:
  *   The parameter file must contain the following information, in this strict
@@ -64,33 +78,197 @@
  *      lines or lines starting with '#', which are ignored.
  *   6. Name of the output file for the computed statistics (e.g.,
  *      "statistics.csv").
+ *   7. Optionally, the name of the file with the display names of the
+ *      algorithms, lines "<algorithm>,<display name>" (default:
+ *      "data/Alg_names.csv").
 **/
 
 using namespace std;
 
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <unistd.h>
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 #include <ranges>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "best_known.h"
+#include "decimal.h"
+#include "profiler.h"
+#include "results_archive.h"
+#include "summary_index.h"
+#include "tensor.h"
+
 using Index = unsigned int;
-using MatString = vector<vector<string>>;
+using MatDecimal = vector<vector<Decimal>>;
 using MatDouble = vector<vector<double>>;
+using VecDecimal = vector<Decimal>;
 using VecString = vector<string>;
 using VecDouble = vector<double>;
 
+// default file with the display names of the algorithms
+const char* const kDisplayNamesFile = "data/Alg_names.csv";
+
+// Records name as the name of id, both in the interner of the names, which
+// gives the ids in order, and in the vector of the names of the ids.
+static void set_name(StringInterner& ids, VecString& names, Index id,
+                     string_view name) {
+  ids.intern(name);
+  if (names.size() <= id) names.resize(id + 1);
+  names[id] = name;
+}
+
+//-------------------------------------------------------------------
+// Calls f(begin, end) on consecutive blocks of [0, n) covering it, with up
+// to threads threads (the calling one included), so that every block has at
+// least grain elements.  f must only write the data of its own block, and
+// then the outcome does not depend on the number of threads.
+template <class F>
+static void parallel_for(size_t n, unsigned threads, size_t grain, F f) {
+  size_t workers = min<size_t>(max(1u, threads), n / max<size_t>(grain, 1));
+  if (workers <= 1) {
+    if (n > 0) f(0, n);
+    return;
+  }
+  vector<thread> pool;
+  for (size_t w = 1; w < workers; w++)
+    pool.emplace_back(f, n * w / workers, n * (w + 1) / workers);
+  f(0, n / workers);
+  for (thread& t : pool) t.join();
+}
+
+// Number of elements a block of parallel_for must have so that a thread is
+// worth starting, when each of them costs work basic operations.
+static size_t grain_of(size_t work) {
+  const size_t kBlockWork = 1 << 15;
+  return max<size_t>(1, kBlockWork / max<size_t>(work, 1));
+}
+
+//-------------------------------------------------------------------
+// The summary file of option -i, and the row of every instance name.
+struct InstanceSummary {
+  SummaryIndex index;
+  unordered_map<string_view, Index> rows;
+};
+
+// Loads the summary file filename, from its binary index if it is fresh
+// (which is reported if verbose).  Returns nullptr if it does not exist.
+static shared_ptr<InstanceSummary> load_summary(const string& filename,
+                                                bool verbose) {
+  auto summary = make_shared<InstanceSummary>();
+  string indexname = SummaryIndex::index_name(filename);
+  if (summary->index.map_index(indexname, filename)) {
+    if (verbose) cout << "Using binary index " << indexname << endl;
+  } else if (!summary->index.parse(filename))
+    return nullptr;
+  for (Index k = 0; k != summary->index.size(); ++k)
+    summary->rows.try_emplace(summary->index.names[k], k);
+  return summary;
+}
+
+//-------------------------------------------------------------------
+// The temporary files of the streaming mode, removed once closed.  Exits
+// if one cannot be created.
+static shared_ptr<FILE> temporary_file() {
+  FILE* file = tmpfile();
+  if (file == nullptr) {
+    cerr << "Cannot create a temporary file" << endl;
+    exit(EXIT_FAILURE);
+  }
+  return shared_ptr<FILE>(file, fclose);
+}
+
+// Writes (if write) or reads bytes bytes of data at offset at of file.
+// Exits on an error.
+static void temporary_io(FILE* file, void* data, size_t bytes, uint64_t at,
+                         bool write) {
+  char* p = static_cast<char*>(data);
+  while (bytes > 0) {
+    ssize_t done = write ? pwrite(fileno(file), p, bytes, at)
+                         : pread(fileno(file), p, bytes, at);
+    if (done < 0 && errno == EINTR) continue;
+    if (done <= 0) {
+      cerr << "Cannot " << (write ? "write" : "read") << " a temporary file"
+           << endl;
+      exit(EXIT_FAILURE);
+    }
+    p += done;
+    bytes -= done;
+    at += done;
+  }
+}
+
+//-------------------------------------------------------------------
+// reduction facilities
+// The struct 'TopTwo' accumulates the largest value of a set, how many times
+// it occurs and the largest of the other values, so that the maximum of the
+// set without any one of its elements is available in constant time.
+template <class T>
+struct TopTwo {
+  T first{};       // the largest value
+  T second{};      // the largest value smaller than first, if has_second
+  Index count = 0;  // number of elements equal to first
+  bool has_second = false;  // whether some element is smaller than first
+
+  void add(const T& v) {
+    if (count == 0 || v > first) {
+      if (count > 0) {
+        second = first;
+        has_second = true;
+      }
+      first = v;
+      count = 1;
+    } else if (v == first) {
+      ++count;
+    } else if (!has_second || v > second) {
+      second = v;
+      has_second = true;
+    }
+  }
+
+  // The maximum of the set without one of its elements, whose value is v.
+  // If the set has no other element T() is returned.
+  const T& max_but(const T& v) const {
+    return (count == 1 && v == first) ? second : first;
+  }
+};
+
 //-------------------------------------------------------------------
 class tablegenerator {
  public:
   double time_limit_scaling;
   bool absolute_values;
+  unsigned n_threads = 1;  // threads parsing the results file and computing
+                           // the statistics and the bootstrap
+  // bootstrap replicates of the statistics (0: no confidence intervals) and
+  // the level of their confidence intervals
+  Index bootstrap_replicates = 0;
+  double bootstrap_confidence = 0.95;
+  // in streaming mode (option -O), bytes of the results of a block of
+  // instances, 0 if the results file is loaded in memory
+  size_t stream_budget = 0;
 
  private:
   string nameresults;   // this contains the names of the output file
@@ -99,148 +277,176 @@ class tablegenerator {
   string algorithm_set;  // this may be "all_algorithms" or "some_algorithms"
   string algorithm_names_file;  // file containing names of algorithms in trial
   string statfilename;  // file containing the name of the statistics file
+  // file with the display names of the algorithms
+  string display_names_file = kDisplayNamesFile;
   Index nalgorithms;    // number of algorithms
   Index ninstances;     // number of instances
   Index n_seeds;        // number of seeds
-  vector<vector<vector<double>>> resultsdata;
-  vector<vector<vector<string>>> resultsdata_str;
-  vector<vector<vector<string>>> resultstime;
-
-  unordered_map<string, Index> Inst_names;
-  unordered_map<string, Index> Algo_names;
-  unordered_map<string, Index> Seed_names;
+  // results indexed by (instance, algorithm, seed); runs that do not appear
+  // in the results file are marked as not present and count as 0.  In
+  // streaming mode they only hold the instances of a block, from
+  // block_first on.
+  Tensor3<Decimal> resultsdata;
+  Tensor3<Decimal> resultstime;
+  Tensor3<unsigned char> present;
+  Index block_first = 0;
+  bool missing_reported = false;  // WarnMissingRuns is done in streaming mode
+  // in streaming mode, the value and time of every run, located while the
+  // results file is read, in a temporary file where the runs of a block of
+  // instances, from block_start[b] to block_start[b + 1], are the runs
+  // block_offset[b] to block_offset[b + 1], in order of the results file
+  struct StreamedRun {
+    Index inst, algo, seed;
+    Decimal value, time;
+  };
+  shared_ptr<FILE> spill;
+  vector<uint64_t> inst_runs;  // runs of every instance in spill
+  vector<Index> block_start;
+  vector<uint64_t> block_offset;
+
+  // the results file, possibly shared with other generators, and, for every
+  // record that is not skipped, the seed, instance and algorithm it refers
+  // to
+  shared_ptr<ResultsArchive> archive;
+  struct Run {
+    size_t record;
+    Index seed, inst, algo;
+  };
+  vector<Run> runs;
+  bool results_read = false;
+  // ids of the instances, algorithms and seeds of the archive, or one of
+  // the following codes, and what read_results_file reports about them
+  static constexpr Index unset = numeric_limits<Index>::max();
+  static constexpr Index skipped = unset - 1;
+  vector<Index> inst_map, algo_map, seed_map;
+  vector<bool> used_instances, used_algorithms;
+  Index skipped_inst = 0, skipped_alg = 0;
+  unordered_map<string, string> display_names;  // from display_names_file
+  // the summary file and the selection of its rows by the predicate of
+  // option -f, if any
+  shared_ptr<InstanceSummary> summary;
+  vector<bool> summary_selected;
+
+  StringInterner Inst_names;
+  StringInterner Algo_names;
+  StringInterner Seed_names;
+  // name of every id, and display name of every algorithm
+  VecString Inst_name, Algo_name, Seed_name;
+  VecString Algo_display;
 
   // STATISTICS
   MatDouble SumBySeeds_mat;
-  MatString MaxBySeeds_mat, MinBySeeds_mat, TimeMaxBySeeds_mat;
-  VecDouble MaxByAlg_SumBySeeds_vect;
+  MatDecimal MaxBySeeds_mat, MinBySeeds_mat, TimeMaxBySeeds_mat;
+  // (instance, k, algorithm): min (k = 0), mean (k = 1) and max (k = 2) of
+  // the values over the seeds, as doubles, for the deviations
+  Tensor3<double> BySeeds_dbl;
+  // seed of every (instance, algorithm) giving MaxBySeeds_mat, and
+  // algorithm of every instance giving MaxByAlg_MaxBySeeds_vect
+  vector<vector<Index>> SeedMaxBySeeds_mat;
+  vector<Index> AlgMaxByAlg_vect;
   VecDouble FE;
-  MatDouble MaxByAlgButOne_SumBySeeds_mat;
-  VecString MaxByAlg_MaxBySeeds_vect, TimeMaxByAlg_MaxBySeeds_vect;
+  vector<TopTwo<double>> TopTwo_SumBySeeds_vect;
+  VecDecimal MaxByAlg_MaxBySeeds_vect, TimeMaxByAlg_MaxBySeeds_vect;
+  VecDouble MaxByAlg_MaxBySeeds_dbl;  // MaxByAlg_MaxBySeeds_vect as doubles
   VecDouble FS;
   VecDouble BA;
-  MatString MaxByAlgButOne_MaxBySeeds_mat;
+  vector<TopTwo<Decimal>> TopTwo_MaxBySeeds_vect, TopTwo_MinBySeeds_vect;
   VecDouble SBA1, SBA2, EBA;
   VecDouble WD, MD, BD;
   VecDouble AR, ASR;
+  Tensor3<Index> Rank_mat;  // rank of (instance, seed, algorithm), of the
+                            // block in streaming mode
+  vector<vector<Index>> RankSumBySeeds_mat;  // sum of the ranks over seeds
+  // time scaling and absolute_values of the statistics above (NaN if they
+  // have not been computed)
+  double stats_scaling = numeric_limits<double>::quiet_NaN();
+  bool stats_absolute_values = false;
+  // threads of every statistic computed by AggregateStatistics
+  unsigned stat_threads = 1;
+  // instances whose results changed since the statistics were computed
+  vector<Index> updated_instances;
+  // bounds of the bootstrap confidence intervals of (metric, algorithm), the
+  // metrics being FE, FS, BA, EBA, WD, MD, BD, AR
+  static constexpr Index kMetrics = 8;
+  MatDouble CI_low, CI_high;
 
  private:
+  void load_archive();
+  void ResetIds();
+  void ReplayRecords(size_t first);
+  void CheckSelection(uint64_t lines);
+  void AllocateResults();
+  size_t MissingRuns() const;
+  void WarnMissingRuns(size_t missing);
+  uint64_t StreamResults();
+  void PartitionRuns();
+  void StreamInstances();
+  void LocateResults();
+  void StoreResults(const int32_t* located, size_t first = 0);
   void AllocateStatistics();
-  void SumBySeeds();
-  void MaxByAlg(MatDouble& in_mat, VecDouble& out_vect);
-  //  void MaxByAlg(MatString& in_mat, VecString& out_vect);
-  void MaxByAlg(MatString& in_mat, MatString& time_in_mat, VecString& out_vect,
-                VecString& time_out_vect);
+  vector<Index> AllInstances() const;
+  void ReduceInstances(const vector<Index>& instances);
+  void AggregateStatistics();
+  void SumBySeeds(const vector<Index>& instances);
+  template <class T>
+  void TopTwoByAlg(vector<vector<T>>& in_mat, vector<TopTwo<T>>& out_vect,
+                   const vector<Index>& instances);
+  //  void MaxByAlg(MatDecimal& in_mat, VecDecimal& out_vect);
+  void MaxByAlg(MatDecimal& in_mat, MatDecimal& time_in_mat,
+                VecDecimal& out_vect, VecDecimal& time_out_vect,
+                VecDouble& double_out_vect, vector<Index>& arg_out_vect,
+                const vector<Index>& instances);
+  template <class P>
+  void CountByAlg(VecDouble& out, P pred);
   void FirstEqualPercentage();
-  void MaxByAlgButOne(MatDouble& in_mat, MatDouble& out_mat);
-  void MaxByAlgButOne(MatString& in_mat, MatString& out_mat);
   void FirstStrictPercentage();
-  void MaxBySeeds();
+  void MaxBySeeds(const vector<Index>& instances);
   void BestAchievedPercentage();
   void EarliestBestAchievedPercentage();
-  void MinBySeeds();
-  void WorstDeviations();
-  void MeanDeviations();
-  void BestDeviations();
+  void MinBySeeds(const vector<Index>& instances);
+  void Deviations();
+  void RankAlgorithms(const vector<Index>& instances);
   void AvgRank();
+  void Bootstrap();
+  string table_header() const;
+  void read_display_names();
+  bool store_display_names(ResultsArchive& results) const;
+  void write_table_rows(ostream& fout, const string& prefix);
+  bool satisfies_predicate(string_view name) const;
 
  public:
   tablegenerator() = default;
 
   void read_parameters(char* filename);
+  bool filter_instances(const shared_ptr<InstanceSummary>& instances,
+                        const string& predicate, ostream& err);
   void read_selected_instances();
   void read_selected_algorithms();
   void read_results_file();
-  void extract(int level, char* filename);
-  void extractChamp(Index cMetric, char* Alg_name, char* filename);
+  void stream_results_file();
+  void compile_results_file();
+  bool append_results_file(const char* delta, string& error);
+  void share_results(const tablegenerator& other) { archive = other.archive; }
+  void rescale(double scaling);
+  void extract(int level, ostream& fout);
+  void extractChamp(Index cMetric, const string& Alg_name, ostream& fout);
+  bool has_algorithm(const string& Alg_name) const {
+    return Algo_names.find(Alg_name) != StringInterner::kNone;
+  }
+  void write_ranks(ostream& fout);
+  void best_known(BestKnownIndex& index);
+  void write_dominance(ostream& fout);
+  void write_profiles(const VecDouble& fractions, const VecString& labels,
+                      const VecDouble& tolerances,
+                      const VecString& tolerance_labels, ostream& fout);
   void ComputeStatistics();
-  void writetable();
+  void UpdateStatistics();
+  void writetable(ostream& fout);
+  void sweep(const VecDouble& scalings, const VecString& labels,
+             ostream& fout);
   void Set_instances_set() { instance_set = "all_instances"; }
-};
-
-// Helper function to adjust the position of the decimal point in a
-// string representation of a number.  It handles scientific notation
-// (e.g., "1.2e3") and moves the decimal accordingly.  It also removes
-// leading/trailing zeros and returns the final decimal point
-// position.
-auto dotpos = [](string& v) {
-  // Initialize exponent and decimal position.
-  int e = 0;
-  int pos = v.length();
-
-  // Check for scientific notation (e.g., "1.2e3").
-  if (v.find('e') != string::npos) {
-    // Extract exponent value.
-    e = stoi(v.substr(v.find('e') + 1, string::npos));
-    // Remove the exponent part from the string.
-    v = v.substr(0, v.find('e'));
-  }
-
-  // Check for a decimal point.
-  if (v.find('.') != string::npos) {
-    // Find the position of the decimal point.
-    pos = v.find('.');
-    // Remove the decimal point.
-    v.erase(v.begin() + pos);
-  } else {
-    // If no decimal point, the effective position is at the end.
-    pos = v.length();
-  }
-
-  // Adjust the decimal position based on the exponent.
-  pos += e;
-
-  // Handle negative decimal positions (e.g., moving decimal left).
-  if (pos < 0) {
-    // Add leading zeros to shift decimal to the right.
-    v.insert(0, -pos, '0');
-    pos = 0;
-  }
-  // Handle positive decimal positions (e.g., moving decimal right).
-  if (pos > static_cast<int>(v.length())) {
-    // Add trailing zeros to shift decimal to the left.
-    v.append(pos - v.length(), '0');
-  }
-
-  // Remove leading zeros after decimal adjustment.
-  int trail = 0;
-  for (; trail < pos; ++trail) {
-    if (v[trail] != '0') break;
-  }
-  if (trail > 0) {
-    v.erase(v.begin(), v.begin() + trail);
-    pos -= trail;
-  }
-
-  return pos;
-};
-
-// Comparison function for string representations of numbers, taking into
-// account the decimal point position and potentially different lengths.
-auto gte = [](string u, string v) {
-  // Get the adjusted decimal positions.
-  int du = dotpos(u);
-  int dv = dotpos(v);
-
-  // Normalize lengths for comparison if decimal positions are the same.
-  if (du == dv) {
-    if (u.length() < v.length()) {
-      u.append(v.length() - u.length(), '0');
-    } else if (u.length() > v.length()) {
-      v.append(u.length() - v.length(), '0');  // Pad v instead of u
-    }
-  }
-  // Comparison logic:
-  // - If u's decimal position is to the right of v's (du > dv), u is greater.
-  // - If decimal positions are the same, lexicographically compare the strings.
-  // - If neither condition is met, v is greater.
-  if ((du > dv) || (du == dv && u.compare(v) > 0)) {
-    return 1;  // u is greater than v
-  } else if (du == dv && u.compare(v) == 0) {
-    return 0;  // u is equal to v
-  } else {
-    return -1;  // u is less than v
-  }
+  const string& statistics_file() const { return statfilename; }
+  const string& results_file() const { return nameresults; }
 };
 
 // Trims leading and trailing whitespace from a string.
@@ -252,47 +458,6 @@ auto trim = [](string str) {
   return str;
 };
 
-// Extracts the correct value and time from a string containing a
-// history of values and times.  It searches for the last entry within
-// a given time limit.
-auto trueValue = [](string& str, double limit) {
-  const char delimiter = ';';  // Delimiter for separating value-time pairs
-  const char separator = ':';  // Separator for value and time within a pair
-  string token;                // Temporary holder for each value-time pair
-  string val;                  // Extracted value
-  string time;                 // Extracted time
-
-  // Iterate through the string from the end (ignoring the last two characters).
-  for (int pos = str.size() - 2; pos > 0;) {
-    // Find the last occurrence of the delimiter within the current position.
-    int new_pos = str.rfind(delimiter, pos);
-    // If no delimiter is found, set to beginning of the string
-    if (new_pos == static_cast<int>(string::npos)) new_pos = 0;
-
-    // Extract the value-time pair.
-    token = str.substr(new_pos + 1, pos - new_pos);
-    // Extract value and time based on the separator.
-    val = token.substr(0, token.find(separator));
-    time = token.substr(token.find(separator) + 1, token.size() - 1);
-
-    // Check if the time is within the limit.
-    if (stod(time) <= limit) {
-      // If at the very end of the string and no valid value is found
-      // before the end, clear val.
-      if (pos == static_cast<int>(str.size() - 2)) val = "";
-      break;  // Exit the loop if a valid entry is found.
-    }
-
-    // Move the search position to the next delimiter.
-    pos = new_pos - 1;
-    // reset the values if not found
-    val = "0";
-    time = "0";
-  }
-  // Return the extracted value and time as a pair.
-  return make_pair(val, time);
-};
-
 //-------------------------------------------------------------------
 // sorting facilities
 // The struct 'couple' contains a criteria (statistics) and an index
@@ -330,6 +495,7 @@ void tablegenerator::read_parameters(char* filename) {
   // - <algorithm file name> (only if algorithms to consider is
   //   "some_algorithms")
   // - name of the output file with the computed statistics
+  // - optionally, the file with the display names of the algorithms
   //
   // 'instance file name' and 'algorithm file name' may contain blank lines
   // or lines starting with character '#'. These lines are skipped.
@@ -373,11 +539,43 @@ void tablegenerator::read_parameters(char* filename) {
     exit(EXIT_FAILURE);
   }
 
+  string names_file;
+  if (fin >> names_file) display_names_file = names_file;
+
   fin.close();
 }
 
+//-------------------------------------------------------------------
+bool tablegenerator::filter_instances(
+    const shared_ptr<InstanceSummary>& instances, const string& predicate,
+    ostream& err) {
+  // The instances are restricted to those of the summary instances whose
+  // row satisfies predicate; read_selected_instances and ReplayRecords
+  // apply the restriction: the other instances are skipped, as those
+  // missing from the instance file, by id, and with "some_instances" the
+  // instances of the file must satisfy predicate as well.  Returns false,
+  // after writing the error to err, if predicate is not valid.
+  SummaryPredicate pred;
+  string error;
+  if (!pred.compile(predicate, error)) {
+    err << "Invalid predicate \"" << predicate << "\": " << error << endl;
+    return false;
+  }
+  summary = instances;
+  pred.evaluate(summary->index, summary_selected);
+  return true;
+}
+
+//-------------------------------------------------------------------
+bool tablegenerator::satisfies_predicate(string_view name) const {
+  if (summary == nullptr) return true;
+  auto it = summary->rows.find(name);
+  return it != summary->rows.end() && summary_selected[it->second];
+}
+
 //-------------------------------------------------------------------
 void tablegenerator::read_selected_instances() {
+  ScopedStage stage("read_selected_instances");
   if (instance_set == "all_instances") return;
   ifstream fin;
   fin.open(instance_names_file);
@@ -393,7 +591,11 @@ void tablegenerator::read_selected_instances() {
     if (line == "" || line[0] == '#') continue;  // skip comment lines
     Index pos = line.find("\r");  // in MSDOS files, lines end with \r\n
     token = line.substr(0, pos);
-    if (Inst_names.try_emplace(token, InstIdx).second) ++InstIdx;
+    if (!satisfies_predicate(token)) continue;  // excluded by option -f
+    if (Inst_names.intern(token) == InstIdx) {  // a new name
+      Inst_name.push_back(token);
+      ++InstIdx;
+    }
   }
   ninstances = InstIdx;
   fin.close();
@@ -401,6 +603,7 @@ void tablegenerator::read_selected_instances() {
 
 //-------------------------------------------------------------------
 void tablegenerator::read_selected_algorithms() {
+  ScopedStage stage("read_selected_algorithms");
   if (algorithm_set == "all_algorithms") return;
   ifstream fin;
   fin.open(algorithm_names_file);
@@ -416,157 +619,110 @@ void tablegenerator::read_selected_algorithms() {
     if (line == "" || line[0] == '#') continue;  // skip comment lines
     Index pos = line.find("\r");  // in MSDOS files, lines end with \r\n
     token = line.substr(0, pos);
-    if (Algo_names.try_emplace(token, AlgoIdx).second) ++AlgoIdx;
+    if (Algo_names.intern(token) == AlgoIdx) {  // a new name
+      Algo_name.push_back(token);
+      ++AlgoIdx;
+    }
   }
   nalgorithms = AlgoIdx;
   fin.close();
 }
 
 //-------------------------------------------------------------------
-void tablegenerator::read_results_file() {
-  ifstream fin;
-  fin.open(nameresults);
-  if (!fin.is_open()) {
+void tablegenerator::compile_results_file() {
+  ScopedStage stage("compile_results_file");
+  ResultsArchive archive;
+  if (!archive.parse(nameresults, n_threads)) {
     cerr << "File " << nameresults << " does not exist" << endl;
     exit(EXIT_FAILURE);
   }
-  string line;
-  string line0;
-  // file results contains a header in the first row, which we skip
-  getline(fin, line);
-  //
-  const string delimeter = ",";
-  Index pos = 0;
-  string token;
-  vector<bool> used_instances;
-  vector<bool> used_algorithms;
-
-  if (instance_set == "some_instances") {
-    used_instances.resize(ninstances, false);
+  profiler.count("bytes_read", archive.bytes_read);
+  profiler.count("lines_parsed", archive.n_lines);
+  store_display_names(archive);
+  string cachename = ResultsArchive::cache_name(nameresults);
+  if (!archive.write_cache(cachename, nameresults)) {
+    cerr << "Cannot write file " << cachename << endl;
+    exit(EXIT_FAILURE);
   }
+  cout << "Compiled " << archive.n_records() << " records of " << nameresults
+       << " into " << cachename << endl;
+}
 
-  if (algorithm_set == "some_algorithms") {
-    used_algorithms.resize(nalgorithms, false);
+//-------------------------------------------------------------------
+void tablegenerator::load_archive() {
+  // The binary cache of the results file is used whenever it is present and
+  // fresh; otherwise the text file is parsed.
+  // The archive may already have been loaded by another generator (see
+  // share_results).
+  if (archive != nullptr) return;
+  ScopedStage stage("load_archive");
+  archive = make_shared<ResultsArchive>();
+  string cachename = ResultsArchive::cache_name(nameresults);
+  if (archive->map_cache(cachename, nameresults)) {
+    cout << "Using binary cache " << cachename << endl;
+  } else if (!archive->parse(nameresults, n_threads)) {
+    cerr << "File " << nameresults << " does not exist" << endl;
+    exit(EXIT_FAILURE);
+  } else {
+    profiler.count("lines_parsed", archive->n_lines);
   }
+  profiler.count("bytes_read", archive->bytes_read);
+}
 
-  // read subsequent lines
+//-------------------------------------------------------------------
+void tablegenerator::read_results_file() {
+  ScopedStage stage("read_results_file");
+  load_archive();
+  ResetIds();
+  ReplayRecords(0);
+  CheckSelection(archive->n_lines);
+  AllocateResults();
+  LocateResults();
+}
 
-  Index skipped_alg = 0;
-  Index skipped_inst = 0;
+//-------------------------------------------------------------------
+void tablegenerator::stream_results_file() {
+  // This function gives the ids of the instances, algorithms and seeds, as
+  // read_results_file, in streaming mode: the results file is read once,
+  // by chunks, and only the value and time of every run are kept, in a
+  // temporary file ordered by block of instances (see StreamResults,
+  // PartitionRuns and StreamInstances).
+
+  ScopedStage stage("stream_results_file");
+  ResetIds();
+  uint64_t lines = StreamResults();
+  CheckSelection(lines);
+  PartitionRuns();
+  results_read = true;
+}
 
-  Index InstIdx = 0;
-  Index AlgoIdx = 0;
-  Index SeedIdx = 0;
-  Index nLine = 0;
-  while (getline(fin, line)) {
-    Index Ind = 0;
-    bool skip = false;
-    bool doBreak = false;
-    double limit = 0.0;
-    Index Algo = 0;
-    Index Seed = 0;
-    Index Inst = 0;
-    string Time;
-    string Value;
-    pair<string, string> P;
-    nLine++;
-    line += delimeter;
-    line0 = line;
-    while ((pos = line.find(delimeter)) != static_cast<Index>(string::npos)) {
-      token = line.substr(0, pos);
-      line.erase(0, pos + delimeter.length());
-      switch (Ind) {
-        case 0:  // timestamp
-          break;
-        case 1:  // graphname
-          if (instance_set == "some_instances") {
-            if (Inst_names.find(token) == Inst_names.end()) {
-              skip = true;
-              ++skipped_inst;
-            } else {
-              used_instances[Inst_names[token]] = true;
-              Inst = Inst_names[token];
-            }
-          } else {
-            if (Inst_names.try_emplace(token, InstIdx).second) ++InstIdx;
-            Inst = Inst_names[token];
-          }
-          break;
-        case 2:  // algorithm
-          if (algorithm_set == "some_algorithms") {
-            if (Algo_names.find(token) == Algo_names.end()) {
-              skip = true;
-              ++skipped_alg;
-            } else {
-              used_algorithms[Algo_names[token]] = true;
-              Algo = Algo_names[token];
-            }
-          } else {
-            if (Algo_names.try_emplace(token, AlgoIdx).second) ++AlgoIdx;
-            Algo = Algo_names[token];
-          }
-          break;
-        case 3:  // seed
-          if (Seed_names.try_emplace(token, SeedIdx).second) ++SeedIdx;
-          Seed = Seed_names[token];
-          break;
-        case 4:  // time limit
-          limit = stod(token) * time_limit_scaling;
-        case 5:  // objective
-          Value = token;
-          break;
-        case 6:  // time
-          Time = token;
-          break;
-        case 7:  // history
-          P = trueValue(token, limit);
-          if (P.first.size() > 0) {
-            Value = P.first;
-            Time = P.second;
-          }
-          doBreak = true;
-          break;
-      }
-      Ind++;
-      if (skip or doBreak) break;
-    }
-    if (!skip) {
-      if (Seed >= resultsdata.size()) {
-	Index size = Seed + 1;
-        resultsdata.resize(size);
-        resultsdata_str.resize(size);
-        resultstime.resize(size);
-      }
-      if (Inst >= resultsdata[Seed].size()) {
-	Index size = Inst + 1;
-        if (instance_set == "some_instances")
-	  size = ninstances;
-	resultsdata[Seed].resize(size);
-	resultsdata_str[Seed].resize(size);
-	resultstime[Seed].resize(size);
-      }
-      if (Algo >= resultsdata[Seed][Inst].size()) {
-	Index size = Algo + 1;
-        if (algorithm_set == "some_algorithms")
-	  size = nalgorithms;
-	resultsdata[Seed][Inst].resize(size);
-	resultsdata_str[Seed][Inst].resize(size);
-	resultstime[Seed][Inst].resize(size);
-      }
-      
-      // If the triple Seed,Inst,Algo appears again, we overwrite the
-      // previous entry
-      resultsdata_str[Seed][Inst][Algo] = Value;
-      resultsdata[Seed][Inst][Algo] = stod(Value);
-      resultstime[Seed][Inst][Algo] = Time;
-    }
+//-------------------------------------------------------------------
+void tablegenerator::ResetIds() {
+  if (instance_set == "some_instances") {
+    used_instances.assign(ninstances, false);
+  } else {
+    ninstances = 0;
   }
-  n_seeds = SeedIdx;
-  fin.close();
 
-  if (instance_set == "all_instances")
-    ninstances = InstIdx;
-  else {
+  if (algorithm_set == "some_algorithms") {
+    used_algorithms.assign(nalgorithms, false);
+  } else {
+    nalgorithms = 0;
+  }
+  n_seeds = 0;
+  skipped_inst = skipped_alg = 0;
+  runs.clear();
+  inst_map.clear();
+  algo_map.clear();
+  seed_map.clear();
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::CheckSelection(uint64_t lines) {
+  // This function checks that all the instances and algorithms of the
+  // selection files appear in the results file, which has lines data
+  // lines, and reports the records skipped.
+  if (instance_set == "some_instances") {
     bool found = false;
     for (Index i = 0; i != ninstances; ++i)
       if (!used_instances[i]) {
@@ -580,16 +736,14 @@ void tablegenerator::read_results_file() {
            << "         do not appear in file " << nameresults << endl
            << "         Execution is aborted." << endl
            << endl;
-      for (auto& name : Inst_names)
-        if (!used_instances[Inst_names[name.first]]) cerr << name.first << endl;
+      for (Index i = 0; i != ninstances; ++i)
+        if (!used_instances[i]) cerr << Inst_name[i] << endl;
       cerr << endl;
     }
     if (found) exit(EXIT_FAILURE);
   }
 
-  if (algorithm_set == "all_algorithms")
-    nalgorithms = AlgoIdx;
-  else {
+  if (algorithm_set == "some_algorithms") {
     bool found = false;
     for (Index i = 0; i != nalgorithms; ++i)
       if (!used_algorithms[i]) {
@@ -603,65 +757,574 @@ void tablegenerator::read_results_file() {
            << "         do not appear in file " << nameresults << endl
            << "         Execution is aborted." << endl
            << endl;
-      for (auto& name : Algo_names)
-        if (!used_algorithms[Algo_names[name.first]])
-          cerr << name.first << endl;
+      for (Index h = 0; h != nalgorithms; ++h)
+        if (!used_algorithms[h]) cerr << Algo_name[h] << endl;
       cerr << endl;
     }
     if (found) exit(EXIT_FAILURE);
   }
 
-  cout << "Read " << nLine << " records. " << endl;
+  cout << "Read " << lines << " records. " << endl;
   cout << skipped_inst << " where skipped because uninteresting "
        << "instances" << endl;
   cout << skipped_alg << " where skipped because uninteresting "
        << "algorithms" << endl;
 }
 
+//-------------------------------------------------------------------
+void tablegenerator::ReplayRecords(size_t first) {
+  // This function maps the records of the archive from first on to runs.
+  // Ids of the archive are mapped to the ids used here: when all instances
+  // (algorithms) are analyzed they are numbered in order of first appearance
+  // among the records that are not skipped, otherwise the ids given in the
+  // selection file are used.  Seeds are always numbered in order of first
+  // appearance.
+
+  ScopedStage stage("ReplayRecords");
+  Index old_skipped_inst = skipped_inst, old_skipped_alg = skipped_alg;
+  size_t old_runs = runs.size();
+  Index old_inst = inst_map.size();
+  Index old_algo = algo_map.size();
+  inst_map.resize(archive->inst_names.size(), unset);
+  algo_map.resize(archive->alg_names.size(), unset);
+  seed_map.resize(archive->seed_names.size(), unset);
+  if (instance_set == "some_instances")
+    for (Index k = old_inst; k != inst_map.size(); ++k) {
+      Index id = Inst_names.find(archive->inst_names[k]);
+      inst_map[k] = id == StringInterner::kNone ? skipped : id;
+    }
+  else if (summary != nullptr)
+    // the predicate of option -f, as a mask over the ids of the archive
+    for (Index k = old_inst; k != inst_map.size(); ++k)
+      if (!satisfies_predicate(archive->inst_names[k])) inst_map[k] = skipped;
+  if (algorithm_set == "some_algorithms")
+    for (Index k = old_algo; k != algo_map.size(); ++k) {
+      Index id = Algo_names.find(archive->alg_names[k]);
+      algo_map[k] = id == StringInterner::kNone ? skipped : id;
+    }
+
+  // when all instances (algorithms) are analyzed, ninstances (nalgorithms)
+  // is the number of ids given so far
+  for (size_t r = first; r != archive->n_records(); ++r) {
+    Index& Inst = inst_map[archive->rec_inst[r]];
+    if (Inst == unset) {
+      Inst = ninstances++;
+      set_name(Inst_names, Inst_name, Inst,
+               archive->inst_names[archive->rec_inst[r]]);
+    }
+    if (Inst == skipped) {
+      ++skipped_inst;
+      continue;
+    }
+    if (instance_set == "some_instances") used_instances[Inst] = true;
+
+    Index& Algo = algo_map[archive->rec_alg[r]];
+    if (Algo == unset) {
+      Algo = nalgorithms++;
+      set_name(Algo_names, Algo_name, Algo,
+               archive->alg_names[archive->rec_alg[r]]);
+    }
+    if (Algo == skipped) {
+      ++skipped_alg;
+      continue;
+    }
+    if (algorithm_set == "some_algorithms") used_algorithms[Algo] = true;
+
+    Index& Seed = seed_map[archive->rec_seed[r]];
+    if (Seed == unset) {
+      Seed = n_seeds++;
+      set_name(Seed_names, Seed_name, Seed,
+               archive->seed_names[archive->rec_seed[r]]);
+    }
+    runs.push_back({r, Seed, Inst, Algo});
+  }
+  profiler.count("records_replayed", archive->n_records() - first);
+  profiler.count("records_skipped_instance", skipped_inst - old_skipped_inst);
+  profiler.count("records_skipped_algorithm", skipped_alg - old_skipped_alg);
+  profiler.count("runs", runs.size() - old_runs);
+}
+
+//-------------------------------------------------------------------
+bool tablegenerator::append_results_file(const char* delta, string& error) {
+  // This function merges the runs of the results file delta into the
+  // results file and its binary cache: only delta is parsed, its records are
+  // appended to the archive, its data lines to the results file, and the
+  // cache is written again from the archive.  If the results have already
+  // been read, the new runs are stored as well and the instances they
+  // concern are marked for the update of the statistics.
+  // Returns false, with the message in error, if delta cannot be parsed or
+  // the results file or the cache cannot be written; the archive and the
+  // results file are then left as they were.
+
+  ScopedStage stage("append_results_file");
+  load_archive();
+  size_t first_record = archive->n_records();
+  ResultsArchive::Mark mark = archive->mark();
+  if (!archive->append_file(delta, n_threads, &error)) return false;
+  profiler.count("bytes_read", archive->bytes_read - mark.bytes_read);
+  profiler.count("lines_parsed", archive->n_lines - mark.n_lines);
+
+  // The data lines of delta follow the last line of the results file,
+  // which is terminated if needed; an empty results file gets the header of
+  // delta as well.
+  ifstream fin(delta, ios::binary);
+  ifstream fres(nameresults, ios::binary | ios::ate);
+  bool existed = fres.is_open();
+  off_t old_size = existed ? off_t(fres.tellg()) : 0;
+  struct stat old_stat{};
+  existed = existed && stat(nameresults.c_str(), &old_stat) == 0;
+  bool empty = old_size <= 0;
+  bool terminated = true;
+  if (!empty) {
+    fres.seekg(-1, ios::end);
+    terminated = fres.get() == '\n';
+  }
+  fres.close();
+  // undoes the append, on an error; the modification time of the results
+  // file is restored as well, so that its cache is still used
+  auto fail = [&](const string& message) {
+    struct timespec times[2] = {old_stat.st_atim, old_stat.st_mtim};
+    if (!existed)
+      remove(nameresults.c_str());
+    else if (truncate(nameresults.c_str(), old_size) != 0 ||
+             utimensat(AT_FDCWD, nameresults.c_str(), times, 0) != 0)
+      cerr << "Cannot restore file " << nameresults << endl;
+    archive->truncate(mark);
+    error = message;
+    return false;
+  };
+  ofstream fout(nameresults, ios::binary | ios::app);
+  if (!fout.is_open()) return fail("Cannot write file " + nameresults);
+  if (!terminated) fout << '\n';
+  string line;
+  if (!empty) getline(fin, line);  // the header of delta
+  while (getline(fin, line)) fout << line << '\n';
+  fout.close();
+  if (!fout) return fail("Cannot write file " + nameresults);
+
+  if (!archive->display_names_fresh(display_names_file))
+    store_display_names(*archive);
+  string cachename = ResultsArchive::cache_name(nameresults);
+  if (!archive->write_cache(cachename, nameresults))
+    return fail("Cannot write file " + cachename);
+  cout << "Appended " << archive->n_records() - first_record
+       << " records of " << delta << " to " << nameresults << " and "
+       << cachename << endl;
+
+  if (!results_read) return true;
+  Index old_inst = ninstances, old_algo = nalgorithms, old_seeds = n_seeds;
+  size_t first_run = runs.size();
+  ReplayRecords(first_record);
+  vector<bool> updated(ninstances, false);
+  if (ninstances != old_inst || nalgorithms != old_algo ||
+      n_seeds != old_seeds) {
+    // the new runs enlarge the tensors: all instances are updated
+    resultsdata.resize(ninstances, nalgorithms, n_seeds);
+    resultstime.resize(ninstances, nalgorithms, n_seeds);
+    present.resize(ninstances, nalgorithms, n_seeds, false);
+    stats_scaling = numeric_limits<double>::quiet_NaN();
+  }
+  vector<int32_t> located(runs.size() - first_run);
+  uint64_t scanned = 0;  // history entries examined
+  for (size_t k = first_run; k != runs.size(); ++k) {
+    const Run& run = runs[k];
+    present(run.inst, run.algo, run.seed) = true;
+    located[k - first_run] = archive->locate(
+        run.record, archive->rec_limit[run.record] * time_limit_scaling);
+    if (profiler.enabled)
+      scanned += archive->scanned(run.record, located[k - first_run]);
+    if (!updated[run.inst]) {
+      updated[run.inst] = true;
+      updated_instances.push_back(run.inst);
+    }
+  }
+  profiler.count("history_scanned", scanned);
+  StoreResults(located.data(), first_run);
+  cout << runs.size() - first_run << " new runs on "
+       << count(updated.begin(), updated.end(), true) << " instances"
+       << endl;
+  WarnMissingRuns(MissingRuns());
+  return true;
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::LocateResults() {
+  // This function stores the value and time of every run at the time limits
+  // scaled by time_limit_scaling.
+
+  ScopedStage stage("LocateResults");
+  vector<int32_t> located(runs.size());
+  uint64_t scanned = 0;  // history entries examined
+  for (Index k = 0; k != runs.size(); ++k) {
+    size_t r = runs[k].record;
+    located[k] = archive->locate(r, archive->rec_limit[r] * time_limit_scaling);
+    if (profiler.enabled) scanned += archive->scanned(r, located[k]);
+  }
+  profiler.count("history_scanned", scanned);
+  StoreResults(located.data());
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::rescale(double scaling) {
+  if (scaling == time_limit_scaling) return;
+  time_limit_scaling = scaling;
+  LocateResults();
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::AllocateResults() {
+  // allocate tensors ninstances x nalgorithms x n_seeds and mark the runs
+  // that appear in the results file
+
+  ScopedStage stage("AllocateResults");
+  resultsdata.assign(ninstances, nalgorithms, n_seeds);
+  resultstime.assign(ninstances, nalgorithms, n_seeds);
+  present.assign(ninstances, nalgorithms, n_seeds, false);
+  for (const Run& run : runs) present(run.inst, run.algo, run.seed) = true;
+  results_read = true;
+  WarnMissingRuns(MissingRuns());
+}
+
+//-------------------------------------------------------------------
+size_t tablegenerator::MissingRuns() const {
+  size_t missing = 0;
+  for (size_t k = 0; k != present.size(); ++k)
+    if (!present.data()[k]) ++missing;
+  return missing;
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::WarnMissingRuns(size_t missing) {
+  if (missing > 0)
+    cout << "WARNING: " << missing << " runs (seed, instance, algorithm) "
+         << "do not appear" << endl
+         << "         in file " << nameresults
+         << "; their value and time are taken as 0" << endl;
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::StoreResults(const int32_t* located, size_t first) {
+  // This function stores the value and time of every run from first on,
+  // located[k - first] being the outcome of ResultsArchive::locate for run k
+  // at the current time limits.
+
+  ScopedStage stage("StoreResults");
+  for (size_t k = first; k != runs.size(); ++k) {
+    const Run& run = runs[k];
+    auto [Value, Time] = archive->value_of(run.record, located[k - first]);
+    // If the triple Seed,Inst,Algo appears again, we overwrite the
+    // previous entry
+    resultsdata(run.inst, run.algo, run.seed) = Value;
+    resultstime(run.inst, run.algo, run.seed) = Time;
+  }
+}
+
+//-------------------------------------------------------------------
+uint64_t tablegenerator::StreamResults() {
+  // This function reads the results file once, by chunks of lines (see
+  // ResultsStream), gives the instances, algorithms and seeds ids as
+  // ReplayRecords does, and writes the value and time of every run at the
+  // current time limits to spill, in order of the results file, along with
+  // their number per instance.  Returns the number of data lines.
+
+  ScopedStage stage("StreamResults");
+  ResultsStream stream;
+  if (!stream.open(nameresults)) {
+    cerr << "File " << nameresults << " does not exist" << endl;
+    exit(EXIT_FAILURE);
+  }
+  // the id of a name that appears for the first time
+  auto new_id = [&](StringInterner& ids, VecString& names, Index& n,
+                    string_view name) {
+    set_name(ids, names, n, name);
+    return n++;
+  };
+  auto instance = [&](string_view name) {
+    Index id = Inst_names.find(name);
+    if (id != StringInterner::kNone) return id;
+    if (instance_set == "some_instances" || !satisfies_predicate(name))
+      return skipped;
+    return new_id(Inst_names, Inst_name, ninstances, name);
+  };
+  auto algorithm = [&](string_view name) {
+    Index id = Algo_names.find(name);
+    if (id != StringInterner::kNone) return id;
+    if (algorithm_set == "some_algorithms") return skipped;
+    return new_id(Algo_names, Algo_name, nalgorithms, name);
+  };
+  auto seed = [&](string_view name) {
+    Index id = Seed_names.find(name);
+    if (id != StringInterner::kNone) return id;
+    return new_id(Seed_names, Seed_name, n_seeds, name);
+  };
+
+  spill = temporary_file();
+  inst_runs.assign(ninstances, 0);
+  // the runs not yet written, at most stream_budget bytes
+  size_t capacity = max<size_t>(1, stream_budget / sizeof(StreamedRun));
+  vector<StreamedRun> pending;
+  uint64_t written = 0;
+  auto flush = [&]() {
+    temporary_io(spill.get(), pending.data(),
+                 pending.size() * sizeof(StreamedRun),
+                 written * sizeof(StreamedRun), true);
+    written += pending.size();
+    pending.clear();
+  };
+
+  ResultsArchive chunk;
+  vector<Index> inst_ids, algo_ids, seed_ids;  // of the names of the chunk
+  uint64_t records = 0, scanned = 0;
+  Index old_skipped_inst = skipped_inst, old_skipped_alg = skipped_alg;
+  while (stream.next(chunk)) {
+    inst_ids.assign(chunk.inst_names.size(), unset);
+    algo_ids.assign(chunk.alg_names.size(), unset);
+    seed_ids.assign(chunk.seed_names.size(), unset);
+    records += chunk.n_records();
+    for (size_t r = 0; r != chunk.n_records(); ++r) {
+      Index& Inst = inst_ids[chunk.rec_inst[r]];
+      if (Inst == unset) Inst = instance(chunk.inst_names[chunk.rec_inst[r]]);
+      if (Inst == skipped) {
+        ++skipped_inst;
+        continue;
+      }
+      if (instance_set == "some_instances") used_instances[Inst] = true;
+      Index& Algo = algo_ids[chunk.rec_alg[r]];
+      if (Algo == unset) Algo = algorithm(chunk.alg_names[chunk.rec_alg[r]]);
+      if (Algo == skipped) {
+        ++skipped_alg;
+        continue;
+      }
+      if (algorithm_set == "some_algorithms") used_algorithms[Algo] = true;
+      Index& Seed = seed_ids[chunk.rec_seed[r]];
+      if (Seed == unset) Seed = seed(chunk.seed_names[chunk.rec_seed[r]]);
+
+      int32_t located =
+          chunk.locate(r, chunk.rec_limit[r] * time_limit_scaling);
+      if (profiler.enabled) scanned += chunk.scanned(r, located);
+      auto [Value, Time] = chunk.value_of(r, located);
+      if (inst_runs.size() <= Inst) inst_runs.resize(Inst + 1, 0);
+      ++inst_runs[Inst];
+      pending.push_back({Inst, Algo, Seed, Value, Time});
+      if (pending.size() == capacity) flush();
+    }
+  }
+  flush();
+  profiler.count("bytes_read", stream.bytes_read);
+  profiler.count("lines_parsed", stream.n_lines);
+  profiler.count("records_replayed", records);
+  profiler.count("records_skipped_instance", skipped_inst - old_skipped_inst);
+  profiler.count("records_skipped_algorithm", skipped_alg - old_skipped_alg);
+  profiler.count("runs", written);
+  profiler.count("history_scanned", scanned);
+  return stream.n_lines;
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::PartitionRuns() {
+  // This function splits the instances into blocks whose results take at
+  // most stream_budget bytes (a block has at least one instance), and
+  // reorders the runs of spill by block, keeping the order of the results
+  // file within a block.  Every run is copied through a buffer of its
+  // block, the buffers taking at most stream_budget bytes together.
+
+  ScopedStage stage("PartitionRuns");
+  inst_runs.resize(ninstances, 0);
+  size_t per_instance = size_t(nalgorithms) * n_seeds *
+                        (2 * sizeof(Decimal) + sizeof(unsigned char) +
+                         sizeof(Index));
+  size_t block = max<size_t>(1, stream_budget / max<size_t>(per_instance, 1));
+  block_start.clear();
+  block_offset.assign(1, 0);
+  for (size_t first = 0; first < ninstances; first += block) {
+    Index last = min<size_t>(ninstances, first + block);
+    block_start.push_back(first);
+    uint64_t n = 0;
+    for (Index i = first; i != last; ++i) n += inst_runs[i];
+    block_offset.push_back(block_offset.back() + n);
+  }
+  block_start.push_back(ninstances);
+  size_t n_blocks = block_offset.size() - 1;
+  if (n_blocks <= 1) return;
+
+  shared_ptr<FILE> sorted = temporary_file();
+  size_t capacity =
+      max<size_t>(1, stream_budget / (n_blocks * sizeof(StreamedRun)));
+  vector<StreamedRun> buffers(n_blocks * capacity);
+  vector<size_t> filled(n_blocks, 0);
+  vector<uint64_t> cursor(block_offset.begin(), block_offset.end() - 1);
+  auto flush = [&](size_t b) {
+    temporary_io(sorted.get(), &buffers[b * capacity],
+                 filled[b] * sizeof(StreamedRun),
+                 cursor[b] * sizeof(StreamedRun), true);
+    cursor[b] += filled[b];
+    filled[b] = 0;
+  };
+  size_t chunk = max<size_t>(1, stream_budget / sizeof(StreamedRun));
+  vector<StreamedRun> in;
+  for (uint64_t k = 0; k < block_offset.back(); k += in.size()) {
+    in.resize(min<uint64_t>(chunk, block_offset.back() - k));
+    temporary_io(spill.get(), in.data(), in.size() * sizeof(StreamedRun),
+                 k * sizeof(StreamedRun), false);
+    for (const StreamedRun& run : in) {
+      size_t b = run.inst / block;
+      buffers[b * capacity + filled[b]++] = run;
+      if (filled[b] == capacity) flush(b);
+    }
+  }
+  for (size_t b = 0; b != n_blocks; ++b) flush(b);
+  spill = sorted;
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::StreamInstances() {
+  // This function computes the reductions of all instances in streaming
+  // mode, block by block (see PartitionRuns): the runs of the instances of
+  // a block are read back from spill and reduced.  The statistics only need
+  // the reductions, of size ninstances x nalgorithms.
+
+  ScopedStage stage("StreamInstances");
+  size_t chunk = max<size_t>(1, stream_budget / sizeof(StreamedRun));
+  vector<StreamedRun> in;
+  size_t missing = 0;
+  for (size_t b = 0; b + 1 < block_offset.size(); ++b) {
+    Index first = block_start[b], last = block_start[b + 1];
+    block_first = first;
+    resultsdata.assign(last - first, nalgorithms, n_seeds);
+    resultstime.assign(last - first, nalgorithms, n_seeds);
+    present.assign(last - first, nalgorithms, n_seeds, false);
+    Rank_mat.assign(last - first, n_seeds, nalgorithms);
+    for (uint64_t k = block_offset[b]; k < block_offset[b + 1];
+         k += in.size()) {
+      in.resize(min<uint64_t>(chunk, block_offset[b + 1] - k));
+      temporary_io(spill.get(), in.data(), in.size() * sizeof(StreamedRun),
+                   k * sizeof(StreamedRun), false);
+      for (const StreamedRun& run : in) {
+        // If the triple Seed,Inst,Algo appears again, we overwrite the
+        // previous entry
+        resultsdata(run.inst - first, run.algo, run.seed) = run.value;
+        resultstime(run.inst - first, run.algo, run.seed) = run.time;
+        present(run.inst - first, run.algo, run.seed) = true;
+      }
+    }
+    missing += MissingRuns();
+    vector<Index> instances;
+    for (Index i = first; i != last; ++i) instances.push_back(i);
+    ReduceInstances(instances);
+  }
+  block_first = 0;
+  if (!missing_reported) WarnMissingRuns(missing);
+  missing_reported = true;
+}
+
 //-------------------------------------------------------------------
 // START COMPUTING METRICS
 //-------------------------------------------------------------------
 void tablegenerator::ComputeStatistics() {
+  ScopedStage stage("ComputeStatistics");
   AllocateStatistics();
-  SumBySeeds();
-  MaxByAlg(SumBySeeds_mat, MaxByAlg_SumBySeeds_vect);
-  FirstEqualPercentage();
-  MaxByAlgButOne(SumBySeeds_mat, MaxByAlgButOne_SumBySeeds_mat);
-  FirstStrictPercentage();
-  MaxBySeeds();
+  if (stream_budget > 0)
+    StreamInstances();
+  else
+    ReduceInstances(AllInstances());
+  AggregateStatistics();
+}
+//-------------------------------------------------------------------
+void tablegenerator::ReduceInstances(const vector<Index>& instances) {
+  // This function computes the reductions over the seeds and the
+  // algorithms of the given instances, from which the statistics are
+  // aggregated.  Every instance is reduced on its own, so each reduction
+  // splits the instances among the threads (see parallel_for).
+
+  ScopedStage stage("ReduceInstances");
+  SumBySeeds(instances);
+  TopTwoByAlg(SumBySeeds_mat, TopTwo_SumBySeeds_vect, instances);
+  MaxBySeeds(instances);
   MaxByAlg(MaxBySeeds_mat, TimeMaxBySeeds_mat, MaxByAlg_MaxBySeeds_vect,
-           TimeMaxByAlg_MaxBySeeds_vect);
-  BestAchievedPercentage();
-  EarliestBestAchievedPercentage();
-  MaxByAlgButOne(MaxBySeeds_mat, MaxByAlgButOne_MaxBySeeds_mat);
-  MinBySeeds();
-  WorstDeviations();
-  MeanDeviations();
-  BestDeviations();
-  AvgRank();
+           TimeMaxByAlg_MaxBySeeds_vect, MaxByAlg_MaxBySeeds_dbl,
+           AlgMaxByAlg_vect, instances);
+  TopTwoByAlg(MaxBySeeds_mat, TopTwo_MaxBySeeds_vect, instances);
+  MinBySeeds(instances);
+  RankAlgorithms(instances);
+}
+//-------------------------------------------------------------------
+void tablegenerator::AggregateStatistics() {
+  // The statistics only read the reductions and each of them writes its own
+  // vector, so they are computed concurrently; each one is computed as in
+  // a serial run, so that the outcome does not depend on the threads.
+  // Once the work of a statistic is worth a thread, every worker computes
+  // one of them and the remaining threads are shared among the statistics,
+  // which split their loops over the instances.
+  ScopedStage stage("AggregateStatistics");
+  void (tablegenerator::*statistics[])() = {
+      &tablegenerator::FirstEqualPercentage,
+      &tablegenerator::FirstStrictPercentage,
+      &tablegenerator::BestAchievedPercentage,
+      &tablegenerator::EarliestBestAchievedPercentage,
+      &tablegenerator::Deviations,
+      &tablegenerator::AvgRank};
+  size_t n = size(statistics);
+  bool concurrent = grain_of(size_t(ninstances) * nalgorithms) == 1;
+  unsigned workers = concurrent ? min<unsigned>(n, max(1u, n_threads)) : 1;
+  stat_threads = max(1u, n_threads / workers);
+  parallel_for(n, workers, 1,
+               [&](size_t begin, size_t end) {
+                 for (size_t k = begin; k != end; ++k) (this->*statistics[k])();
+               });
+  stats_scaling = time_limit_scaling;
+  stats_absolute_values = absolute_values;
+  updated_instances.clear();
+}
+//-------------------------------------------------------------------
+void tablegenerator::UpdateStatistics() {
+  // The statistics are computed only if they are not already available for
+  // the current time scaling and absolute_values.  When only the results of
+  // some instances changed (see append_results_file), only their
+  // reductions are computed again.
+
+  ScopedStage stage("UpdateStatistics");
+  if (stats_scaling != time_limit_scaling) {
+    ComputeStatistics();
+    return;
+  }
+  if (!updated_instances.empty()) ReduceInstances(updated_instances);
+  if (!updated_instances.empty() || stats_absolute_values != absolute_values)
+    AggregateStatistics();
+}
+//-------------------------------------------------------------------
+vector<Index> tablegenerator::AllInstances() const {
+  vector<Index> instances(ninstances);
+  for (Index i = 0; i < ninstances; i++) instances[i] = i;
+  return instances;
 }
 //-------------------------------------------------------------------
 void tablegenerator::AllocateStatistics() {
   // allocate matrices ninstances x nalgorithms
 
+  ScopedStage stage("AllocateStatistics");
   SumBySeeds_mat.resize(ninstances);
   MaxBySeeds_mat.resize(ninstances);
   TimeMaxBySeeds_mat.resize(ninstances);
   MinBySeeds_mat.resize(ninstances);
-  MaxByAlgButOne_SumBySeeds_mat.resize(ninstances);
-  MaxByAlgButOne_MaxBySeeds_mat.resize(ninstances);
+  SeedMaxBySeeds_mat.resize(ninstances);
+  RankSumBySeeds_mat.resize(ninstances);
   for (Index i = 0; i != ninstances; ++i) {
     SumBySeeds_mat[i].resize(nalgorithms);
     MaxBySeeds_mat[i].resize(nalgorithms);
     TimeMaxBySeeds_mat[i].resize(nalgorithms);
     MinBySeeds_mat[i].resize(nalgorithms);
-    MaxByAlgButOne_SumBySeeds_mat[i].resize(nalgorithms);
-    MaxByAlgButOne_MaxBySeeds_mat[i].resize(nalgorithms);
+    SeedMaxBySeeds_mat[i].resize(nalgorithms);
+    RankSumBySeeds_mat[i].resize(nalgorithms);
   }
 
-  MaxByAlg_SumBySeeds_vect.resize(ninstances);
+  TopTwo_SumBySeeds_vect.resize(ninstances);
+  TopTwo_MaxBySeeds_vect.resize(ninstances);
+  TopTwo_MinBySeeds_vect.resize(ninstances);
   MaxByAlg_MaxBySeeds_vect.resize(ninstances);
   TimeMaxByAlg_MaxBySeeds_vect.resize(ninstances);
+  MaxByAlg_MaxBySeeds_dbl.resize(ninstances);
+  AlgMaxByAlg_vect.resize(ninstances);
+  BySeeds_dbl.assign(ninstances, 3, nalgorithms);
 
   FE.resize(nalgorithms);
   FS.resize(nalgorithms);
@@ -671,227 +1334,237 @@ void tablegenerator::AllocateStatistics() {
   MD.resize(nalgorithms);
   BD.resize(nalgorithms);
   AR.resize(nalgorithms);
+  if (stream_budget == 0) Rank_mat.assign(ninstances, n_seeds, nalgorithms);
 }
 
 //-------------------------------------------------------------------
-void tablegenerator::SumBySeeds() {
+void tablegenerator::SumBySeeds(const vector<Index>& instances) {
   // This function computes:
   // for each instance and for each algorithm the sum of the values for each
   // seed XLS: Somma5
 
-  for (Index i = 0; i < ninstances; i++)
-    for (Index h = 0; h < nalgorithms; h++) {
-      SumBySeeds_mat[i][h] = 0;
-      for (Index seed = 0; seed < n_seeds; seed++)
-        SumBySeeds_mat[i][h] += resultsdata[seed][i][h];
+  ScopedStage stage("SumBySeeds");
+  auto reduce = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k != end; ++k) {
+      Index i = instances[k];
+      for (Index h = 0; h < nalgorithms; h++) {
+        const Decimal* values = resultsdata.row(i - block_first, h);
+        SumBySeeds_mat[i][h] = 0;
+        for (Index seed = 0; seed < n_seeds; seed++)
+          SumBySeeds_mat[i][h] += values[seed].to_double();
+        BySeeds_dbl(i, 1, h) = SumBySeeds_mat[i][h] / n_seeds;
+      }
     }
+  };
+  parallel_for(instances.size(), n_threads,
+               grain_of(size_t(nalgorithms) * n_seeds), reduce);
 }
 //-------------------------------------------------------------------
-void tablegenerator::MaxByAlg(MatDouble& in_mat, VecDouble& out_vect) {
+template <class T>
+void tablegenerator::TopTwoByAlg(vector<vector<T>>& in_mat,
+                                 vector<TopTwo<T>>& out_vect,
+                                 const vector<Index>& instances) {
   // This function computes:
-  // for each instance the maximum of the sum of the values for each seed
-  // in_mat[ninstances][nalgorithms] may be SumBySeeds or MaxBySeeds
-  // out_vect[ninstances] can be a temporary vector of dimension ninstances
-
-  for (Index i = 0; i < ninstances; i++) {
-    out_vect[i] = in_mat[i][0];
-    for (Index h = 1; h < nalgorithms; h++)
-      if (out_vect[i] < in_mat[i][h]) out_vect[i] = in_mat[i][h];
-  }
+  // for each instance the two largest values among the algorithms, so that
+  // the maximum excluding any algorithm is available in constant time
+  // in_mat[ninstances][nalgorithms] may be SumBySeeds, MaxBySeeds or
+  // MinBySeeds
+
+  ScopedStage stage("TopTwoByAlg");
+  auto reduce = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k != end; ++k) {
+      Index i = instances[k];
+      out_vect[i] = TopTwo<T>();
+      for (Index h = 0; h < nalgorithms; h++) out_vect[i].add(in_mat[i][h]);
+    }
+  };
+  parallel_for(instances.size(), n_threads, grain_of(nalgorithms), reduce);
 }
 //-------------------------------------------------------------------
-void tablegenerator::MaxByAlg(MatString& in_mat, MatString& time_in_mat,
-                              VecString& out_vect, VecString& time_out_vect) {
+void tablegenerator::MaxByAlg(MatDecimal& in_mat, MatDecimal& time_in_mat,
+                              VecDecimal& out_vect, VecDecimal& time_out_vect,
+                              VecDouble& double_out_vect,
+                              vector<Index>& arg_out_vect,
+                              const vector<Index>& instances) {
   // This function computes:
   // for each instance the maximum of the sum of the values for each seed
   // in_mat[ninstances][nalgorithms] may be SumBySeeds or MaxBySeeds
   // out_vect[ninstances] can be a temporary vector of dimension ninstances
-
-  for (Index i = 0; i < ninstances; i++) {
-    out_vect[i] = in_mat[i][0];
-    time_out_vect[i] = time_in_mat[i][0];
-    for (Index h = 1; h < nalgorithms; h++)
-      if ((gte(out_vect[i], in_mat[i][h])) < 0 ||
-          ((gte(out_vect[i], in_mat[i][h]) == 0) &&
-           (gte(time_out_vect[i], time_in_mat[i][h]) > 0))) {
-        out_vect[i] = in_mat[i][h];
-        time_out_vect[i] = time_in_mat[i][h];
-      }
-  }
+  // double_out_vect[ninstances] receives out_vect as doubles, and
+  // arg_out_vect[ninstances] the algorithm giving it
+
+  ScopedStage stage("MaxByAlg");
+  auto reduce = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k != end; ++k) {
+      Index i = instances[k];
+      out_vect[i] = in_mat[i][0];
+      time_out_vect[i] = time_in_mat[i][0];
+      arg_out_vect[i] = 0;
+      for (Index h = 1; h < nalgorithms; h++)
+        if (out_vect[i] < in_mat[i][h] ||
+            (out_vect[i] == in_mat[i][h] &&
+             time_out_vect[i] > time_in_mat[i][h])) {
+          out_vect[i] = in_mat[i][h];
+          time_out_vect[i] = time_in_mat[i][h];
+          arg_out_vect[i] = h;
+        }
+      double_out_vect[i] = out_vect[i].to_double();
+    }
+  };
+  parallel_for(instances.size(), n_threads, grain_of(nalgorithms), reduce);
 }
 //-------------------------------------------------------------------
-void tablegenerator::FirstEqualPercentage() {
-  // FE(h) = |\{ i |   \sum_s x^s_h,i = max_h \sum_s x^s_h,i \}|   / ninstances
-
+template <class P>
+void tablegenerator::CountByAlg(VecDouble& out, P pred) {
+  // Sets out[h] to the number of instances i such that pred(i, h), as a
+  // percentage of the instances unless absolute_values.  The instances are
+  // split among stat_threads threads, whose partial counts are integers
+  // and are added in any order.
+
+  vector<Index> counts(nalgorithms, 0);
+  mutex counts_mutex;
+  parallel_for(ninstances, stat_threads, grain_of(nalgorithms),
+               [&](size_t begin, size_t end) {
+    vector<Index> partial(nalgorithms, 0);
+    for (size_t i = begin; i != end; i++)
+      for (Index h = 0; h < nalgorithms; h++)
+        if (pred(i, h)) ++partial[h];
+    lock_guard<mutex> lock(counts_mutex);
+    for (Index h = 0; h < nalgorithms; h++) counts[h] += partial[h];
+  });
   for (Index h = 0; h < nalgorithms; h++) {
-    FE[h] = 0;
-    for (Index i = 0; i < ninstances; i++)
-      if (SumBySeeds_mat[i][h] == MaxByAlg_SumBySeeds_vect[i])
-        FE[h] = FE[h] + 1.0;
-    if (!absolute_values) FE[h] /= ninstances;
-  }
-}
-//-------------------------------------------------------------------
-void tablegenerator::MaxByAlgButOne(MatDouble& in_mat, MatDouble& out_mat) {
-  // This function computes:
-  // for each instance and for each algorithm the maximum excluding the
-  // algorithm itself of the sum of the values for each seed
-
-  for (Index i = 0; i < ninstances; i++) {
-    for (Index h = 0; h < nalgorithms; h++) {
-      Index h1;
-      if (h > 0) {
-        out_mat[i][h] = in_mat[i][0];
-        for (h1 = 1; h1 < h; h1++)
-          if (out_mat[i][h] < in_mat[i][h1]) out_mat[i][h] = in_mat[i][h1];
-        h1 = h + 1;
-      } else {
-        out_mat[i][0] = in_mat[i][1];
-        h1 = 2;
-      }
-      for (; h1 < nalgorithms; h1++)
-        if (out_mat[i][h] < in_mat[i][h1]) out_mat[i][h] = in_mat[i][h1];
-    }
+    out[h] = counts[h];
+    if (!absolute_values) out[h] /= ninstances;
   }
 }
 //-------------------------------------------------------------------
-void tablegenerator::MaxByAlgButOne(MatString& in_mat, MatString& out_mat) {
-  // This function computes:
-  // for each instance and for each algorithm the maximum excluding the
-  // algorithm itself of the sum of the values for each seed
+void tablegenerator::FirstEqualPercentage() {
+  // FE(h) = |\{ i |   \sum_s x^s_h,i = max_h \sum_s x^s_h,i \}|   / ninstances
 
-  for (Index i = 0; i < ninstances; i++) {
-    for (Index h = 0; h < nalgorithms; h++) {
-      Index h1;
-      if (h > 0) {
-        out_mat[i][h] = in_mat[i][0];
-        for (h1 = 1; h1 < h; h1++)
-          if (gte(out_mat[i][h], in_mat[i][h1]) < 0)
-            out_mat[i][h] = in_mat[i][h1];
-        h1 = h + 1;
-      } else {
-        out_mat[i][0] = in_mat[i][1];
-        h1 = 2;
-      }
-      for (; h1 < nalgorithms; h1++)
-        if (gte(out_mat[i][h], in_mat[i][h1]) < 0)
-          out_mat[i][h] = in_mat[i][h1];
-    }
-  }
+  ScopedStage stage("FirstEqualPercentage");
+  CountByAlg(FE, [&](Index i, Index h) {
+    return SumBySeeds_mat[i][h] == TopTwo_SumBySeeds_vect[i].first;
+  });
 }
 //-------------------------------------------------------------------
 void tablegenerator::FirstStrictPercentage() {
   // FS(h) = |\{ i |   \sum_s x^s_h,i > max_h \sum_s x^s_h,i \}|   / ninstances
 
-  for (Index h = 0; h < nalgorithms; h++) {
-    FS[h] = 0;
-    for (Index i = 0; i < ninstances; i++)
-      if (SumBySeeds_mat[i][h] > MaxByAlgButOne_SumBySeeds_mat[i][h])
-        FS[h] = FS[h] + 1.0;
-    if (!absolute_values) FS[h] /= ninstances;
-  }
+  ScopedStage stage("FirstStrictPercentage");
+  CountByAlg(FS, [&](Index i, Index h) {
+    return SumBySeeds_mat[i][h] >
+           TopTwo_SumBySeeds_vect[i].max_but(SumBySeeds_mat[i][h]);
+  });
 }
 //-------------------------------------------------------------------
-void tablegenerator::MaxBySeeds() {
+void tablegenerator::MaxBySeeds(const vector<Index>& instances) {
   // This function computes:
   // for each instance and for each algorithm the max of the values for each
   // seed XLS: Max5
 
-  for (Index i = 0; i < ninstances; i++)
-    for (Index h = 0; h < nalgorithms; h++) {
-      MaxBySeeds_mat[i][h] = resultsdata_str[0][i][h];
-      TimeMaxBySeeds_mat[i][h] = resultstime[0][i][h];
-      for (Index seed = 1; seed < n_seeds; seed++)
-        if (gte(MaxBySeeds_mat[i][h], resultsdata_str[seed][i][h]) < 0 ||
-            (gte(MaxBySeeds_mat[i][h], resultsdata_str[seed][i][h]) == 0 &&
-             gte(TimeMaxBySeeds_mat[i][h], resultstime[seed][i][h]) > 0)) {
-          MaxBySeeds_mat[i][h] = resultsdata_str[seed][i][h];
-          TimeMaxBySeeds_mat[i][h] = resultstime[seed][i][h];
-        }
+  ScopedStage stage("MaxBySeeds");
+  auto reduce = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k != end; ++k) {
+      Index i = instances[k];
+      for (Index h = 0; h < nalgorithms; h++) {
+        const Decimal* values = resultsdata.row(i - block_first, h);
+        const Decimal* times = resultstime.row(i - block_first, h);
+        MaxBySeeds_mat[i][h] = values[0];
+        TimeMaxBySeeds_mat[i][h] = times[0];
+        SeedMaxBySeeds_mat[i][h] = 0;
+        for (Index seed = 1; seed < n_seeds; seed++)
+          if (MaxBySeeds_mat[i][h] < values[seed] ||
+              (MaxBySeeds_mat[i][h] == values[seed] &&
+               TimeMaxBySeeds_mat[i][h] > times[seed])) {
+            MaxBySeeds_mat[i][h] = values[seed];
+            TimeMaxBySeeds_mat[i][h] = times[seed];
+            SeedMaxBySeeds_mat[i][h] = seed;
+          }
+        BySeeds_dbl(i, 2, h) = MaxBySeeds_mat[i][h].to_double();
+      }
     }
+  };
+  parallel_for(instances.size(), n_threads,
+               grain_of(size_t(nalgorithms) * n_seeds), reduce);
 }
 //-------------------------------------------------------------------
-void tablegenerator::MinBySeeds() {
+void tablegenerator::MinBySeeds(const vector<Index>& instances) {
   // This function computes:
   // for each instance and for each algorithm the min of the values for each
   // seed
 
-  for (Index i = 0; i < ninstances; i++)
-    for (Index h = 0; h < nalgorithms; h++) {
-      MinBySeeds_mat[i][h] = resultsdata_str[0][i][h];
-      for (Index seed = 1; seed < n_seeds; seed++)
-        if (gte(MinBySeeds_mat[i][h], resultsdata_str[seed][i][h]) > 0)
-          MinBySeeds_mat[i][h] = resultsdata_str[seed][i][h];
+  ScopedStage stage("MinBySeeds");
+  auto reduce = [&](size_t begin, size_t end) {
+    for (size_t k = begin; k != end; ++k) {
+      Index i = instances[k];
+      for (Index h = 0; h < nalgorithms; h++) {
+        const Decimal* values = resultsdata.row(i - block_first, h);
+        MinBySeeds_mat[i][h] = values[0];
+        for (Index seed = 1; seed < n_seeds; seed++)
+          if (MinBySeeds_mat[i][h] > values[seed])
+            MinBySeeds_mat[i][h] = values[seed];
+        BySeeds_dbl(i, 0, h) = MinBySeeds_mat[i][h].to_double();
+      }
     }
+  };
+  parallel_for(instances.size(), n_threads,
+               grain_of(size_t(nalgorithms) * n_seeds), reduce);
 }
 //-------------------------------------------------------------------
 void tablegenerator::BestAchievedPercentage() {
   // BA(h) = |\{ i |   \max_s x^s_h,i = max_h \max_s x^s_h,i \}|   / ninstances
 
-  for (Index h = 0; h < nalgorithms; h++) {
-    BA[h] = 0;
-    for (Index i = 0; i < ninstances; i++)
-      if (gte(MaxBySeeds_mat[i][h], MaxByAlg_MaxBySeeds_vect[i]) == 0)
-        BA[h] += 1.0;
-    if (!absolute_values) BA[h] /= ninstances;
-  }
+  ScopedStage stage("BestAchievedPercentage");
+  CountByAlg(BA, [&](Index i, Index h) {
+    return MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i];
+  });
 }
 //-------------------------------------------------------------------
 void tablegenerator::EarliestBestAchievedPercentage() {
   // EBA(h) = |\{ i |   \max_s x^s_h,i = max_h \max_s x^s_h,i \}|   / ninstances
 
-  for (Index h = 0; h < nalgorithms; h++) {
-    EBA[h] = 0;
-    for (Index i = 0; i < ninstances; i++)
-      if ((gte(MaxBySeeds_mat[i][h], MaxByAlg_MaxBySeeds_vect[i]) == 0) &&
-          (gte(TimeMaxBySeeds_mat[i][h], TimeMaxByAlg_MaxBySeeds_vect[i]) == 0))
-        EBA[h] += 1.0;
-    if (!absolute_values) EBA[h] /= ninstances;
-  }
+  ScopedStage stage("EarliestBestAchievedPercentage");
+  CountByAlg(EBA, [&](Index i, Index h) {
+    return (MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i]) &&
+           (TimeMaxBySeeds_mat[i][h] == TimeMaxByAlg_MaxBySeeds_vect[i]);
+  });
 }
 //-------------------------------------------------------------------
-void tablegenerator::WorstDeviations() {
-  // This must be as small as possible. Denotes if the algorithm "h" has high
-  // chances to be the best WD(h) = 1 − ( sum_i  (min_s  x^s_h,i)/(max_h1 max_s
-  // x^s_h1,i )) / |I|
-
-  for (Index h = 0; h < nalgorithms; h++) {
-    double somma = 0;
-    for (Index i = 0; i < ninstances; i++) {
-      double den = stod(MaxByAlg_MaxBySeeds_vect[i]);
-      if (den > 0) somma += stod(MinBySeeds_mat[i][h]) / den;
-    }
-    WD[h] = 1 - somma / ninstances;
-  }
-}
-//-------------------------------------------------------------------
-void tablegenerator::MeanDeviations() {
+void tablegenerator::Deviations() {
+  // This function computes the worst, mean and best deviations
+  // WD(h) = 1 − ( sum_i  (min_s  x^s_h,i)/(max_h1 max_s x^s_h1,i )) / |I|
   // MD(h) = 1 −  sum_i  ( \sum_s  x^s_h,i / n_seeds) / ( max_h1,i  x^s_h1,i ))
   // / |I|
-  for (Index h = 0; h < nalgorithms; h++) {
-    double somma = 0;
-    for (Index i = 0; i < ninstances; i++) {
-      double den = stod(MaxByAlg_MaxBySeeds_vect[i]);
-      if (den > 0) somma += (SumBySeeds_mat[i][h] / n_seeds) / den;
-    }
-    MD[h] = 1 - somma / ninstances;
-  }
-}
-//-------------------------------------------------------------------
-void tablegenerator::BestDeviations() {
   // BD(h) = 1 − ( sum_i  (max_s  x^s_h,i)/(max_h1 max_s x^s_h1,i )) / |I|
-
-  for (Index h = 0; h < nalgorithms; h++) {
-    double somma = 0;
+  // WD must be as small as possible. Denotes if the algorithm "h" has high
+  // chances to be the best.
+  // The min, mean and max of an instance are contiguous doubles in
+  // BySeeds_dbl, so the three sums are computed in one pass over the
+  // instances by a loop over those 3 x nalgorithms doubles; every sum adds
+  // the instances in order, as if computed alone.  Partial sums over blocks
+  // of instances would round differently, so the doubles are split among
+  // the threads instead, each thread adding all instances for its own.
+
+  ScopedStage stage("Deviations");
+  size_t width = 3 * size_t(nalgorithms);
+  VecDouble somma(width, 0.0);
+  parallel_for(width, stat_threads, grain_of(ninstances),
+               [&](size_t begin, size_t end) {
     for (Index i = 0; i < ninstances; i++) {
-      double den = stod(MaxByAlg_MaxBySeeds_vect[i]);
-      if (den > 0) somma += stod(MaxBySeeds_mat[i][h]) / den;
+      double den = MaxByAlg_MaxBySeeds_dbl[i];
+      if (!(den > 0)) continue;
+      const double* ratios = BySeeds_dbl.row(i, 0);
+      for (size_t k = begin; k < end; k++) somma[k] += ratios[k] / den;
     }
-    BD[h] = 1 - somma / ninstances;
+  });
+  for (Index h = 0; h < nalgorithms; h++) {
+    WD[h] = 1 - somma[h] / ninstances;
+    MD[h] = 1 - somma[nalgorithms + h] / ninstances;
+    BD[h] = 1 - somma[2 * size_t(nalgorithms) + h] / ninstances;
   }
 }
 //-------------------------------------------------------------------
-void tablegenerator::AvgRank() {
+void tablegenerator::RankAlgorithms(const vector<Index>& instances) {
   // AR(h) =  \sum_i \sum_s R(h,i,s) / 5 |I|
   //  where R(h,i,s) = rank of the objective value of heuristic h on replicate s
   //  of instance i
@@ -901,51 +1574,386 @@ void tablegenerator::AvgRank() {
   //  Rank 1 indicates the best performance among all heuristics, and rank 37
   //  indicates the worst performance.
 
-  for (Index h = 0; h < nalgorithms; h++) {
-    AR[h] = 0.0;
-    for (Index i = 0; i < ninstances; i++)
+  //  For every instance and seed the algorithms are sorted by decreasing
+  //  value, so that all their ranks are assigned at once: the rank of h is 1
+  //  plus the number of results better than h.  Ranks are kept in Rank_mat
+  //  for write_ranks, and their sums over the seeds in RankSumBySeeds_mat
+  //  for AvgRank and Bootstrap.
+  //  This function ranks the algorithms on the given instances, AvgRank
+  //  averages the ranks.
+
+  ScopedStage stage("RankAlgorithms");
+  auto rank_instances = [&](size_t begin, size_t end) {
+    vector<Index> order(nalgorithms);
+    for (size_t j = begin; j != end; ++j) {
+      Index i = instances[j];
+      Index b = i - block_first;
+      vector<Index>& sums = RankSumBySeeds_mat[i];
+      fill(sums.begin(), sums.end(), 0);
       for (Index seed = 0; seed < n_seeds; seed++) {
-        string* vect = new string[nalgorithms];
-        for (Index h1 = 0; h1 < nalgorithms; h1++)
-          vect[h1] = resultsdata_str[seed][i][h1];
-
-        Index r = 0;  // r computes the number of results better than h
-        Index s = 0;  // s computes the number of results equal to h
-        for (Index h1 = 0; h1 < nalgorithms; h1++) {
-          if ((h1 != h) && (gte(vect[h1], vect[h]) > 0)) r++;
-          if ((h1 != h) && (gte(vect[h1], vect[h]) == 0)) s++;
+        for (Index h = 0; h < nalgorithms; h++) order[h] = h;
+        sort(order.begin(), order.end(), [&](Index h1, Index h2) {
+          return resultsdata(b, h1, seed) > resultsdata(b, h2, seed);
+        });
+        Index* rank = Rank_mat.row(b, seed);
+        for (Index k = 0; k < nalgorithms; k++) {
+          Index h = order[k];
+          Index prev = k > 0 ? order[k - 1] : h;
+          if (k > 0 && resultsdata(b, h, seed) == resultsdata(b, prev, seed))
+            rank[h] = rank[prev];
+          else
+            rank[h] = k + 1;
         }
-        delete[] vect;
-        AR[h] += (1 + r);
+        for (Index h = 0; h < nalgorithms; h++) sums[h] += rank[h];
       }
-    AR[h] /= (n_seeds * ninstances);
+    }
+  };
+  // sorting costs about 8 comparisons per algorithm
+  parallel_for(instances.size(), n_threads,
+               grain_of(size_t(nalgorithms) * n_seeds * 8), rank_instances);
+}
+//-------------------------------------------------------------------
+void tablegenerator::AvgRank() {
+  ScopedStage stage("AvgRank");
+  // the ranks are integers, so their sums over blocks of instances are
+  // exact and are added in any order
+  vector<uint64_t> sums(nalgorithms, 0);
+  mutex sums_mutex;
+  parallel_for(ninstances, stat_threads, grain_of(nalgorithms),
+               [&](size_t begin, size_t end) {
+    vector<uint64_t> partial(nalgorithms, 0);
+    for (size_t i = begin; i != end; i++)
+      for (Index h = 0; h < nalgorithms; h++)
+        partial[h] += RankSumBySeeds_mat[i][h];
+    lock_guard<mutex> lock(sums_mutex);
+    for (Index h = 0; h < nalgorithms; h++) sums[h] += partial[h];
+  });
+  for (Index h = 0; h < nalgorithms; h++)
+    AR[h] = double(sums[h]) / (n_seeds * ninstances);
+}
+//-------------------------------------------------------------------
+void tablegenerator::Bootstrap() {
+  // This function computes the percentile bootstrap confidence intervals of
+  // all metrics, with bootstrap_replicates resamples of the instances.
+  // Every metric is an affine function of the average over the instances of
+  // a contribution of each instance, e.g. 1 or 0 whether the algorithm is
+  // first equal on the instance for FE, so the metrics of a resample are
+  // evaluated by summing the contributions of the instances drawn.
+  // Replicates are computed in parallel, each with its own random stream
+  // seeded by its number, so that the intervals do not depend on the
+  // number of threads.
+
+  ScopedStage stage("Bootstrap");
+  const uint64_t kBootstrapSeed = 20240812;
+  CI_low.assign(kMetrics, VecDouble(nalgorithms, 0.0));
+  CI_high.assign(kMetrics, VecDouble(nalgorithms, 0.0));
+  if (ninstances == 0 || bootstrap_replicates == 0) return;
+
+  // contribution(m, i, h) of instance i to metric m of algorithm h
+  Tensor3<double> contribution(kMetrics, ninstances, nalgorithms);
+  for (Index i = 0; i < ninstances; i++) {
+    double den = MaxByAlg_MaxBySeeds_dbl[i];
+    for (Index h = 0; h < nalgorithms; h++) {
+      contribution(0, i, h) =
+          SumBySeeds_mat[i][h] == TopTwo_SumBySeeds_vect[i].first;
+      contribution(1, i, h) =
+          SumBySeeds_mat[i][h] >
+          TopTwo_SumBySeeds_vect[i].max_but(SumBySeeds_mat[i][h]);
+      contribution(2, i, h) =
+          MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i];
+      contribution(3, i, h) =
+          (MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i]) &&
+          (TimeMaxBySeeds_mat[i][h] == TimeMaxByAlg_MaxBySeeds_vect[i]);
+      contribution(4, i, h) = den > 0 ? BySeeds_dbl(i, 0, h) / den : 0.0;
+      contribution(5, i, h) = den > 0 ? BySeeds_dbl(i, 1, h) / den : 0.0;
+      contribution(6, i, h) = den > 0 ? BySeeds_dbl(i, 2, h) / den : 0.0;
+      contribution(7, i, h) = double(RankSumBySeeds_mat[i][h]) / n_seeds;
+    }
   }
+  // the metric from the sum of the contributions of ninstances instances
+  auto finish = [&](Index m, double sum) {
+    if (m < 4) return absolute_values ? sum : sum / ninstances;
+    if (m < 7) return 1 - sum / ninstances;
+    return sum / ninstances;
+  };
+
+  // replicate(r, m, h): metric m of algorithm h in replicate r
+  Index R = bootstrap_replicates;
+  Tensor3<double> replicate(R, kMetrics, nalgorithms);
+  auto run = [&](Index first, Index last) {
+    VecDouble sum(kMetrics * nalgorithms);
+    for (Index r = first; r < last; r++) {
+      seed_seq seq{kBootstrapSeed, static_cast<uint64_t>(r)};
+      mt19937_64 rng(seq);
+      uniform_int_distribution<Index> draw(0, ninstances - 1);
+      fill(sum.begin(), sum.end(), 0.0);
+      for (Index k = 0; k < ninstances; k++) {
+        Index i = draw(rng);
+        for (Index m = 0; m < kMetrics; m++) {
+          const double* c = contribution.row(m, i);
+          double* s = &sum[m * nalgorithms];
+          for (Index h = 0; h < nalgorithms; h++) s[h] += c[h];
+        }
+      }
+      for (Index m = 0; m < kMetrics; m++)
+        for (Index h = 0; h < nalgorithms; h++)
+          replicate(r, m, h) = finish(m, sum[m * nalgorithms + h]);
+    }
+  };
+  parallel_for(R, n_threads, 1, run);
+
+  // percentile intervals
+  double alpha = 1 - bootstrap_confidence;
+  Index low = static_cast<Index>(floor(alpha / 2 * (R - 1)));
+  Index high = static_cast<Index>(ceil((1 - alpha / 2) * (R - 1)));
+  VecDouble values(R);
+  for (Index m = 0; m < kMetrics; m++)
+    for (Index h = 0; h < nalgorithms; h++) {
+      for (Index r = 0; r < R; r++) values[r] = replicate(r, m, h);
+      sort(values.begin(), values.end());
+      CI_low[m][h] = values[low];
+      CI_high[m][h] = values[high];
+    }
 }
 //-------------------------------------------------------------------
-void tablegenerator::writetable() {
-  // This functions produces a .csv file with delimiters
+void tablegenerator::write_ranks(ostream& fout) {
+  // This function writes the rank computed by AvgRank of every algorithm
+  // (one column per algorithm) for every instance and seed (one row per
+  // pair), for analyses such as the Friedman test.
+
+  ScopedStage stage("write_ranks");
+  fout << "Instance,Seed";
+  for (Index h = 0; h < nalgorithms; h++) fout << "," << Algo_name[h];
+  fout << endl;
+  for (Index i = 0; i < ninstances; i++)
+    for (Index seed = 0; seed < n_seeds; seed++) {
+      fout << Inst_name[i] << "," << Seed_name[seed];
+      for (Index h = 0; h < nalgorithms; h++)
+        fout << "," << Rank_mat(i, seed, h);
+      fout << "\n";
+    }
+}
+//-------------------------------------------------------------------
+void tablegenerator::best_known(BestKnownIndex& index) {
+  // This function sets index to the best known value of every instance,
+  // i.e. MaxByAlg_MaxBySeeds_vect, with its earliest time, the algorithm
+  // and the seed reaching it then and the number of algorithms reaching it
+  // (as for BA), all of them kept by the reductions.
+
+  ScopedStage stage("best_known");
+  index.scaling = time_limit_scaling;
+  for (Index i = 0; i < ninstances; i++) {
+    Index h = AlgMaxByAlg_vect[i];
+    index.push_back(Inst_name[i], MaxByAlg_MaxBySeeds_vect[i],
+                    TimeMaxByAlg_MaxBySeeds_vect[i], Algo_name[h],
+                    Seed_name[SeedMaxBySeeds_mat[i][h]],
+                    TopTwo_MaxBySeeds_vect[i].count);
+  }
+}
+//-------------------------------------------------------------------
+template <class T>
+static void count_wins(const T* block, Index n, Index stride, Index A,
+                       vector<uint64_t>& wins) {
+  // block holds the values of the A algorithms on n instances, those of
+  // algorithm h at block[h * stride], ..., block[h * stride + n - 1].
+  // wins[a * A + b] is increased by the number of instances where a has a
+  // greater value than b.  The innermost loop runs over the instances, with
+  // no branch, so that it is vectorized.
+  for (Index a = 0; a < A; a++) {
+    const T* x = block + static_cast<size_t>(a) * stride;
+    for (Index b = a + 1; b < A; b++) {
+      const T* y = block + static_cast<size_t>(b) * stride;
+      uint32_t greater = 0, less = 0;
+      for (Index k = 0; k < n; k++) {
+        greater += x[k] > y[k];
+        less += x[k] < y[k];
+      }
+      wins[a * A + b] += greater;
+      wins[b * A + a] += less;
+    }
+  }
+}
 
-  // sort the algorithms according FE
-  couple* sortarray = new couple[nalgorithms];
-  for (Index h = 0; h < nalgorithms; h++) {
-    sortarray[h].criteria = FE[h];
-    sortarray[h].criteria2 = -MD[h];
-    sortarray[h].index = h;
+//-------------------------------------------------------------------
+void tablegenerator::write_dominance(ostream& fout) {
+  // This function writes, for every ordered pair of algorithms (a, b), the
+  // number of instances where a beats, ties and loses to b, comparing the
+  // sums over the seeds (as FS) and the best values over the seeds (as BA).
+  // The instances are processed in blocks: the values of all algorithms on
+  // a block are copied into contiguous columns, the best values being
+  // replaced by their dense rank on the instance so that Decimal's are
+  // compared once per instance rather than once per pair; every pair of
+  // columns is then compared by count_wins.
+
+  ScopedStage stage("write_dominance");
+  const Index kBlock = 256;
+  Index A = nalgorithms;
+  vector<uint64_t> wins_sum(A * A, 0), wins_max(A * A, 0);
+  VecDouble sums(static_cast<size_t>(A) * kBlock);
+  vector<uint32_t> maxs(static_cast<size_t>(A) * kBlock);
+  vector<Index> order(A);
+  for (Index first = 0; first < ninstances; first += kBlock) {
+    Index n = min(kBlock, ninstances - first);
+    for (Index k = 0; k < n; k++) {
+      Index i = first + k;
+      for (Index h = 0; h < A; h++) sums[h * kBlock + k] = SumBySeeds_mat[i][h];
+      const VecDecimal& best = MaxBySeeds_mat[i];
+      for (Index h = 0; h < A; h++) order[h] = h;
+      sort(order.begin(), order.end(),
+           [&](Index a, Index b) { return best[a] < best[b]; });
+      uint32_t rank = 0;
+      for (Index j = 0; j < A; j++) {
+        if (j > 0 && best[order[j - 1]] < best[order[j]]) ++rank;
+        maxs[order[j] * kBlock + k] = rank;
+      }
+    }
+    count_wins(sums.data(), n, kBlock, A, wins_sum);
+    count_wins(maxs.data(), n, kBlock, A, wins_max);
   }
-  sort(sortarray, sortarray + nalgorithms, &compare_couple);
 
-  // read algorithm names
+  fout << "Algorithm,Opponent,Wins_sum,Ties_sum,Losses_sum,"
+       << "Wins_max,Ties_max,Losses_max" << endl;
+  for (Index a = 0; a < A; a++)
+    for (Index b = 0; b < A; b++) {
+      if (a == b) continue;
+      fout << Algo_name[a] << "," << Algo_name[b];
+      for (const vector<uint64_t>* wins : {&wins_sum, &wins_max}) {
+        uint64_t w = (*wins)[a * A + b], l = (*wins)[b * A + a];
+        fout << "," << w << "," << ninstances - w - l << "," << l;
+      }
+      fout << "\n";
+    }
+}
+//-------------------------------------------------------------------
+void tablegenerator::write_profiles(const VecDouble& fractions,
+                                    const VecString& labels,
+                                    const VecDouble& tolerances,
+                                    const VecString& tolerance_labels,
+                                    ostream& fout) {
+  // This function writes, for every algorithm, tolerance tau and fraction f
+  // of the time limits, the fraction of the (instance, seed) pairs whose
+  // value at time f * limit is within tau of the best known value of the
+  // instance, i.e. at least best - tau * |best|.  The limits are scaled by
+  // time_limit_scaling, as the ones best is computed at: with -s, f = 1 is
+  // the time of the tables and no run can do better than best.  For a
+  // given tau this is the empirical distribution of the time to target of
+  // the algorithm, and for a given f its performance profile.  The best
+  // known value of an instance is the one of BA (the best of all algorithms
+  // and seeds at the current time limits); missing runs count as 0, as in
+  // the tables.
+  // The values of a run at all fractions are located in a single walk of
+  // its history, merged with the fractions from the largest to the
+  // smallest one.
+
+  ScopedStage stage("write_profiles");
+  Index nfractions = fractions.size(), ntolerances = tolerances.size();
+  vector<Index> order(nfractions);
+  for (Index g = 0; g != nfractions; ++g) order[g] = g;
+  sort(order.begin(), order.end(),
+       [&](Index a, Index b) { return fractions[a] > fractions[b]; });
+
+  // the run of every (instance, algorithm, seed), the last one if it is
+  // repeated
+  const size_t none = numeric_limits<size_t>::max();
+  Tensor3<size_t> run_of(ninstances, nalgorithms, n_seeds, none);
+  for (size_t k = 0; k != runs.size(); ++k)
+    run_of(runs[k].inst, runs[k].algo, runs[k].seed) = runs[k].record;
+
+  // reached(h, t, g): pairs of algorithm h within tolerances[t] at
+  // fractions[order[g]]
+  Tensor3<uint64_t> reached(nalgorithms, ntolerances, nfractions, 0);
+  VecDouble limits(nfractions);
+  vector<int32_t> located(nfractions);
+  VecDecimal values(nfractions);
+  VecDouble targets(ntolerances);
+  uint64_t scanned = 0;  // history entries examined
+  for (Index i = 0; i < ninstances; i++) {
+    const Decimal& best = MaxByAlg_MaxBySeeds_vect[i];
+    double b = best.to_double();
+    for (Index t = 0; t < ntolerances; t++)
+      targets[t] = b - tolerances[t] * fabs(b);
+    for (Index h = 0; h < nalgorithms; h++)
+      for (Index seed = 0; seed < n_seeds; seed++) {
+        size_t r = run_of(i, h, seed);
+        if (r == none) {
+          fill(values.begin(), values.end(), Decimal());
+        } else {
+          for (Index g = 0; g != nfractions; ++g)
+            limits[g] = archive->rec_limit[r] * time_limit_scaling *
+                        fractions[order[g]];
+          archive->locate(r, limits.data(), nfractions, located.data());
+          for (Index g = 0; g != nfractions; ++g)
+            values[g] = archive->value_of(r, located[g]).first;
+          if (profiler.enabled && nfractions > 0)
+            scanned += archive->scanned(r, located[nfractions - 1]);
+        }
+        // a zero tolerance is the exact comparison of BA
+        for (Index t = 0; t < ntolerances; t++) {
+          uint64_t* count = reached.row(h, t);
+          for (Index g = 0; g != nfractions; ++g)
+            count[g] += tolerances[t] == 0.0
+                            ? !(values[g] < best)
+                            : values[g].to_double() >= targets[t];
+        }
+      }
+  }
+  profiler.count("history_scanned", scanned);
+
+  read_display_names();
+  double pairs = static_cast<double>(ninstances) * n_seeds;
+  fout << "Heuristic,Tolerance,Time,Fraction" << endl;
+  for (Index h = 0; h < nalgorithms; h++)
+    for (Index t = 0; t < ntolerances; t++)
+      for (Index l = 0; l != nfractions; ++l) {
+        // position of fractions[l] in order
+        Index g = find(order.begin(), order.end(), l) - order.begin();
+        fout << Algo_display[h] << "," << tolerance_labels[t]
+             << "," << labels[l] << "," << fixed << setprecision(4)
+             << (pairs > 0 ? reached(h, t, g) / pairs : 0.0) << "\n";
+      }
+}
+//-------------------------------------------------------------------
+void tablegenerator::read_display_names() {
+  // This function sets the names of the algorithms to be printed in the
+  // tables.  They are taken from the archive if they are stored there (as
+  // in a binary cache) and file display_names_file has not been modified
+  // since; otherwise the file is read and they are stored in the archive,
+  // to be written along with the cache.  In streaming mode, where there is
+  // no archive, the file is always read.
+  if (display_names.empty()) {
+    ResultsArchive names;
+    ResultsArchive* source = &names;
+    if (stream_budget == 0) {
+      load_archive();
+      source = archive.get();
+    }
+    if (!source->display_names_fresh(display_names_file) &&
+        !store_display_names(*source)) {
+      cerr << "File " << display_names_file << " does not exist" << endl;
+      exit(EXIT_FAILURE);
+    }
+    for (size_t k = 0; k != source->display_keys.size(); ++k)
+      display_names.try_emplace(string(source->display_keys[k]),
+                                string(source->display_values[k]));
+  }
+  for (Index h = Algo_display.size(); h < nalgorithms; h++)
+    Algo_display.push_back(display_names[Algo_name[h]]);
+}
+
+//-------------------------------------------------------------------
+bool tablegenerator::store_display_names(ResultsArchive& results) const {
+  // This function reads file display_names_file, made of lines
+  // "<algorithm>,<display name>", into results.  Returns false if the file
+  // does not exist.
   ifstream fin;
-  fin.open("data/Alg_names.csv");
-  if (!fin.is_open()) {
-    cerr << "File " << "data/Alg_names.csv" << " does not exist" << endl;
-    exit(EXIT_FAILURE);
-  };
+  fin.open(display_names_file);
+  if (!fin.is_open()) return false;
 
-  unordered_map<string, string> names;
   string line;
   string delimeter = ",";
   Index n_line = 0;
+  vector<pair<string, string>> names;
+  unordered_map<string, Index> seen;
 
   while (getline(fin, line)) {
     ++n_line;
@@ -954,29 +1962,54 @@ void tablegenerator::writetable() {
       cerr << "Error at line " << n_line << ") " << line << endl;
       exit(EXIT_FAILURE);
     }
-    if (!names.try_emplace(line.substr(0, pos), line.substr(pos + 1)).second) {
+    if (!seen.try_emplace(line.substr(0, pos), n_line).second) {
       cerr << "Error at line " << n_line << ") " << line << endl;
       exit(EXIT_FAILURE);
     }
+    names.emplace_back(line.substr(0, pos), line.substr(pos + 1));
   }
   fin.close();
+  results.set_display_names(names, display_names_file);
+  return true;
+}
+
+//-------------------------------------------------------------------
+string tablegenerator::table_header() const {
+  // The columns of the statistics in the table, followed by the bounds of
+  // their confidence intervals if these are computed
+  const char* metrics[kMetrics] = {"FE", "FS", "BA", "EBA",
+                                   "WD", "MD", "BD", "AR"};
+  string header;
+  for (Index m = 0; m < kMetrics; m++) header += string(",") + metrics[m];
+  if (bootstrap_replicates > 0)
+    for (Index m = 0; m < kMetrics; m++)
+      header += string(",") + metrics[m] + "_low," + metrics[m] + "_high";
+  return header;
+}
 
-  // print table
-  ofstream fout;
-  fout.open(statfilename);
+//-------------------------------------------------------------------
+void tablegenerator::write_table_rows(ostream& fout, const string& prefix) {
+  // This functions writes one row of the table per algorithm, each
+  // preceded by prefix
+  // With bootstrap_replicates > 0 the rows end with the bounds of the
+  // confidence intervals of the statistics, written as the statistics.
 
-  fout << "Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR" << endl;
+  if (bootstrap_replicates > 0) Bootstrap();
 
+  // sort the algorithms according FE
+  couple* sortarray = new couple[nalgorithms];
   for (Index h = 0; h < nalgorithms; h++) {
-    string name;
-    Index hidx = sortarray[h].index;
+    sortarray[h].criteria = FE[h];
+    sortarray[h].criteria2 = -MD[h];
+    sortarray[h].index = h;
+  }
+  sort(sortarray, sortarray + nalgorithms, &compare_couple);
 
-    for (const auto& [key, value] : Algo_names)
-      if (value == hidx) {
-        name = key;
-        break;
-      }
-    fout << names[name];
+  read_display_names();
+
+  for (Index h = 0; h < nalgorithms; h++) {
+    Index hidx = sortarray[h].index;
+    fout << prefix << Algo_display[hidx];
     if (absolute_values) {
       fout << "," << fixed << setprecision(0) << FE[hidx];
       fout << "," << fixed << setprecision(0) << FS[hidx];
@@ -992,99 +2025,153 @@ void tablegenerator::writetable() {
     fout << "," << fixed << setprecision(2) << MD[hidx] * 100;
     fout << "," << fixed << setprecision(2) << BD[hidx] * 100;
     fout << "," << fixed << setprecision(1) << AR[hidx];
+    if (bootstrap_replicates > 0)
+      for (Index m = 0; m < kMetrics; m++)
+        for (double v : {CI_low[m][hidx], CI_high[m][hidx]}) {
+          if (m < 4 && absolute_values)
+            fout << "," << fixed << setprecision(0) << v;
+          else if (m < 4)
+            fout << "," << fixed << setprecision(1) << v * 100;
+          else if (m < 7)
+            fout << "," << fixed << setprecision(2) << v * 100;
+          else
+            fout << "," << fixed << setprecision(1) << v;
+        }
 
     fout << endl;
   }
-  fout.close();
   delete[] sortarray;
 }
 
-void tablegenerator::extract(int level, char* filename) {
+//-------------------------------------------------------------------
+void tablegenerator::writetable(ostream& fout) {
+  // This functions produces a .csv file with delimiters
+
+  ScopedStage stage("writetable");
+  fout << "Heuristic" << table_header() << endl;
+  write_table_rows(fout, "");
+}
+
+//-------------------------------------------------------------------
+void tablegenerator::sweep(const VecDouble& scalings, const VecString& labels,
+                           ostream& fout) {
+  // This function produces the table for every time scaling in scalings,
+  // all in one long-format .csv file whose first column is the scaling
+  // (as given by labels).
+  // The limits of every run are located in its history in a single walk,
+  // for all scalings at once (from the largest to the smallest one).
+
+  ScopedStage stage("sweep");
+  Index nscalings = scalings.size();
+  vector<Index> order(nscalings);
+  for (Index l = 0; l != nscalings; ++l) order[l] = l;
+  sort(order.begin(), order.end(),
+       [&](Index a, Index b) { return scalings[a] > scalings[b]; });
+
+  // located[l * runs.size() + k]: outcome of the limit of run k scaled by
+  // scalings[order[l]]
+  vector<int32_t> located(nscalings * runs.size());
+  VecDouble limits(nscalings);
+  vector<int32_t> out(nscalings);
+  uint64_t scanned = 0;  // history entries examined
+  for (Index k = 0; k != runs.size(); ++k) {
+    size_t r = runs[k].record;
+    for (Index l = 0; l != nscalings; ++l)
+      limits[l] = archive->rec_limit[r] * scalings[order[l]];
+    archive->locate(r, limits.data(), nscalings, out.data());
+    for (Index l = 0; l != nscalings; ++l)
+      located[l * runs.size() + k] = out[l];
+    if (profiler.enabled && nscalings > 0)
+      scanned += archive->scanned(r, out[nscalings - 1]);
+  }
+  profiler.count("history_scanned", scanned);
+
+  fout << "Scaling,Heuristic" << table_header() << endl;
+  for (Index l = 0; l != nscalings; ++l) {
+    // position of scalings[l] in order
+    Index pos = find(order.begin(), order.end(), l) - order.begin();
+    time_limit_scaling = scalings[l];
+    StoreResults(located.data() + pos * runs.size());
+    ComputeStatistics();
+    write_table_rows(fout, labels[l] + ",");
+  }
+}
+
+void tablegenerator::extract(int level, ostream& fout) {
+  ScopedStage stage("extract");
   double threshold;
   if (level < 0)
     threshold = nalgorithms / 2.0;
   else
     threshold = level;
-  ofstream fout;
   int rejected = 0;
   int accepted = 0;
-  fout.open(filename);
 
-  for (auto& inst : Inst_names) {
-    int i = Inst_names[inst.first];
+  // The best value of an instance is the largest among all algorithms and
+  // seeds (and 0); count is the number of algorithms that find it for all
+  // seeds, i.e. whose minimum over the seeds is the best value.
+  vector<Index> instances = AllInstances();
+  AllocateStatistics();
+  MaxBySeeds(instances);
+  MinBySeeds(instances);
+  TopTwoByAlg(MaxBySeeds_mat, TopTwo_MaxBySeeds_vect, instances);
+  TopTwoByAlg(MinBySeeds_mat, TopTwo_MinBySeeds_vect, instances);
+  // only some of the statistics are computed
+  stats_scaling = numeric_limits<double>::quiet_NaN();
+
+  for (Index i = 0; i != ninstances; ++i) {
+    Decimal best = max(TopTwo_MaxBySeeds_vect[i].first, Decimal());
     int count = 0;
-    string value, best;
-    best = "0";
-
-    for (Index h = 0; h < nalgorithms; ++h) {
-      Index local_count = 0;
-      for (Index s = 0; s < n_seeds; ++s) {
-        value = resultsdata_str[s][i][h];
-        int d = gte(best, value);
-        if (d == 0)
-          ++local_count;
-        else if (d < 0) {
-          count = 0;
-          local_count = 1;
-          best = value;
-        }
-      }
-      if (local_count == n_seeds) ++count;
-    }
+    if (TopTwo_MinBySeeds_vect[i].first == best)
+      count = TopTwo_MinBySeeds_vect[i].count;
 
     if (count > threshold) {
       ++rejected;
     } else if (count >= 0) {
-      fout << inst.first << endl;
+      fout << Inst_name[i] << endl;
       ++accepted;
     }
   }
 
   cout << "Rejected: " << rejected << endl;
   cout << "Accepted: " << accepted << endl;
-
-  fout.close();
 }
 
-void tablegenerator::extractChamp(Index cMetric, char* name,
-				  char* filename) {
-  ofstream fout;
+void tablegenerator::extractChamp(Index cMetric, const string& s_name,
+				  ostream& fout) {
+  ScopedStage stage("extractChamp");
   int rejected = 0;
   int accepted = 0;
-  string s_name(name);
   Index h;
 
-  if (Algo_names.find(s_name) == Algo_names.end()) {
+  h = Algo_names.find(s_name);
+  if (h == StringInterner::kNone) {
     cerr << "*** Algorithm " << s_name << " does not exist!" << endl;
     exit(EXIT_FAILURE);
-  } else {
-    h = Algo_names[s_name];
   }
 
-  fout.open(filename);
-
-  for (auto& inst : Inst_names) {
-    int i = Inst_names[inst.first];
+  for (Index i = 0; i != ninstances; ++i) {
     bool found;
 
     switch (cMetric) {
     case 0:
-      found = SumBySeeds_mat[i][h] == MaxByAlg_SumBySeeds_vect[i];
+      found = SumBySeeds_mat[i][h] == TopTwo_SumBySeeds_vect[i].first;
       break;
     case 1:
-      found = SumBySeeds_mat[i][h] > MaxByAlgButOne_SumBySeeds_mat[i][h];
+      found = SumBySeeds_mat[i][h] >
+              TopTwo_SumBySeeds_vect[i].max_but(SumBySeeds_mat[i][h]);
       break;
     case 2:
-      found = gte(MaxBySeeds_mat[i][h], MaxByAlg_MaxBySeeds_vect[i]) == 0;
+      found = MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i];
       break;
     case 3:
-      found = (gte(MaxBySeeds_mat[i][h], MaxByAlg_MaxBySeeds_vect[i]) == 0) &&
-	(gte(TimeMaxBySeeds_mat[i][h], TimeMaxByAlg_MaxBySeeds_vect[i]) == 0);
+      found = (MaxBySeeds_mat[i][h] == MaxByAlg_MaxBySeeds_vect[i]) &&
+	(TimeMaxBySeeds_mat[i][h] == TimeMaxByAlg_MaxBySeeds_vect[i]);
       break;
     }
 
     if (found) {
-      fout << inst.first << endl;
+      fout << Inst_name[i] << endl;
       ++accepted;
     } else
       ++rejected;
@@ -1092,12 +2179,50 @@ void tablegenerator::extractChamp(Index cMetric, char* name,
 
   cout << "Rejected: " << rejected << endl;
   cout << "Accepted: " << accepted << endl;
+}
 
-  fout.close();
+//-------------------------------------------------------------------
+// Parses a list of time scalings separated by ','. Every element is either a
+// single scaling or a range <first>:<last>:<step>, which stands for all the
+// scalings first, first + step, ... not larger than last.
+bool parse_scalings(const string& list, VecDouble& scalings,
+                    VecString& labels) {
+  size_t start = 0;
+  while (start <= list.length()) {
+    size_t end = list.find(',', start);
+    if (end == string::npos) end = list.length();
+    string item = list.substr(start, end - start);
+    start = end + 1;
+    try {
+      size_t c1 = item.find(':');
+      if (c1 == string::npos) {
+        scalings.push_back(stod(item));
+        labels.push_back(item);
+        continue;
+      }
+      size_t c2 = item.find(':', c1 + 1);
+      if (c2 == string::npos) return false;
+      double first = stod(item.substr(0, c1));
+      double last = stod(item.substr(c1 + 1, c2 - c1 - 1));
+      double step = stod(item.substr(c2 + 1));
+      if (step <= 0 || last < first) return false;
+      Index n = static_cast<Index>((last - first) / step + 1.0e-9);
+      for (Index k = 0; k <= n; ++k) {
+        ostringstream label;
+        label << setprecision(10) << first + k * step;
+        scalings.push_back(stod(label.str()));
+        labels.push_back(label.str());
+      }
+    } catch (const logic_error&) {
+      return false;
+    }
+  }
+  return !scalings.empty();
 }
 
 //-------------------------------------------------------------------
-int main(int argc, char** argv) {
+// Options of a run of the program, or of a query in server mode.
+struct Options {
   char* parameterfile = nullptr;
   char* difficult = nullptr;  // the file with the names of the difficult
                               // instances
@@ -1105,158 +2230,932 @@ int main(int argc, char** argv) {
                               // where algorithm champ is best in the 
                               // cMetric ranking
   char* champ = nullptr;
+  char* ranks = nullptr;  // the file with the rank of every algorithm for
+                          // each instance and seed
+  char* dominance = nullptr;  // the file with the wins, ties and losses of
+                              // every pair of algorithms
+  char* profiles = nullptr;  // the file with the time-to-target profiles
+  char* best = nullptr;      // the file with the best known values
+  int stream = 0;  // megabytes of the results of a block in streaming mode
+  char* grid = nullptr;        // their fractions of the time limits
+  char* tolerances = nullptr;  // and their tolerances
+  char* output = nullptr;  // the statistics file, if not the one given in
+                           // the parameter file
+  char* delta = nullptr;  // the results file to be merged into the results
+  char* summary = nullptr;    // the instance summary file of option -f
+  char* predicate = nullptr;  // the predicate the instances must satisfy
+  char* profile = nullptr;    // the file the profile is appended to
+  int replicates = 0;        // bootstrap replicates
+  double confidence = -1.0;  // level of the confidence intervals
   Index cMetric = 0;
-  int opt;
   int level = -1;  // the level of easiness for the instances
                    // to be put in file difficult
   double scaling = -1.0;
   bool print_help = false;
   bool absolute_values = false;
+  bool compile = false;
+  char* sweep = nullptr;  // the list of time scalings of a sweep
+  int threads = 0;        // threads parsing the results file and computing
+                          // the statistics
+  bool serve = false;     // answer the queries read from stdin
+  char* socket = nullptr;  // answer the queries read from this socket
+  VecDouble scalings;
+  VecString scaling_labels;
+  VecDouble fractions, tolerance_values;  // the lists of -T and -e
+  VecString fraction_labels, tolerance_labels;
+
+  // Whether an output is named "-", i.e. written to the standard output.
+  bool writes_standard_output() const {
+    for (const char* name : {difficult, rInstances, ranks, dominance, profiles,
+                             best, output, profile})
+      if (name != nullptr && strcmp(name, "-") == 0) return true;
+    return false;
+  }
+};
 
-  if (argc == 1)
-    print_help = true;
-  else
-    while ((opt = getopt(argc, argv, "p:s:had:l:c:r:m:")) != -1) {
-      switch (opt) {
-        case 'a':
-          absolute_values = true;
-          break;
-        case 'p':
-          parameterfile = optarg;
-          break;
-        case 'd':
-          difficult = optarg;
-          break;
-        case 'l':
-          level = atoi(optarg);
-          break;
-        case 's':
-          scaling = atof(optarg);
-          break;
-        case 'c':
-          champ = optarg;
-          break;
-        case 'r':
-          rInstances = optarg;
-          break;
-        case 'm':
-          cMetric = atoi(optarg);
-          break;
-        case 'h':
-        default:
-          print_help = true;
-      }
+//-------------------------------------------------------------------
+// Parses the options in argv and checks that they are consistent, writing
+// the errors to err.  The options of a query (in server mode) cannot
+// concern the loading of the results file.  Returns false if the options
+// are illegal or the help message is requested.
+bool parse_options(int argc, char** argv, Options& options, ostream& err,
+                   bool query) {
+  Options& o = options;
+  bool print_help = false;
+  int opt;
+  optind = 0;  // getopt is reinitialized for every query
+  opterr = 0;
+  const char* optstring =
+      ":p:s:had:l:c:r:m:bS:k:t:o:qQ:u:B:L:w:P:T:e:i:f:j:V:O:";
+  while ((opt = getopt(argc, argv, optstring)) != -1) {
+    if (query && strchr("pbtqQjO", opt) != nullptr) {
+      err << "Option -" << static_cast<char>(opt)
+          << " is not allowed in a query" << endl;
+      return false;
+    }
+    switch (opt) {
+      case 'a':
+        o.absolute_values = true;
+        break;
+      case 'p':
+        o.parameterfile = optarg;
+        break;
+      case 'd':
+        o.difficult = optarg;
+        break;
+      case 'l':
+        o.level = atoi(optarg);
+        break;
+      case 's':
+        o.scaling = atof(optarg);
+        break;
+      case 'c':
+        o.champ = optarg;
+        break;
+      case 'r':
+        o.rInstances = optarg;
+        break;
+      case 'm':
+        o.cMetric = atoi(optarg);
+        break;
+      case 'b':
+        o.compile = true;
+        break;
+      case 'S':
+        o.sweep = optarg;
+        break;
+      case 'k':
+        o.ranks = optarg;
+        break;
+      case 'w':
+        o.dominance = optarg;
+        break;
+      case 'P':
+        o.profiles = optarg;
+        break;
+      case 'T':
+        o.grid = optarg;
+        break;
+      case 'e':
+        o.tolerances = optarg;
+        break;
+      case 't':
+        o.threads = atoi(optarg);
+        break;
+      case 'o':
+        o.output = optarg;
+        break;
+      case 'u':
+        o.delta = optarg;
+        break;
+      case 'B':
+        o.replicates = atoi(optarg);
+        break;
+      case 'L':
+        o.confidence = atof(optarg);
+        break;
+      case 'i':
+        o.summary = optarg;
+        break;
+      case 'f':
+        o.predicate = optarg;
+        break;
+      case 'j':
+        o.profile = optarg;
+        break;
+      case 'V':
+        o.best = optarg;
+        break;
+      case 'O':
+        o.stream = atoi(optarg);
+        if (o.stream <= 0) {
+          err << "<megabytes> value must be > 0" << endl;
+          return false;
+        }
+        break;
+      case 'q':
+        o.serve = true;
+        break;
+      case 'Q':
+        o.socket = optarg;
+        break;
+      case ':':
+        err << "Option -" << static_cast<char>(optopt)
+            << " requires an argument" << endl;
+        return false;
+      case '?':
+        err << "Unknown option -" << static_cast<char>(optopt) << endl;
+        return false;
+      case 'h':
+      default:
+        return false;
     }
+  }
+  if (query && optind < argc) {
+    err << "Unexpected argument " << argv[optind] << endl;
+    return false;
+  }
 
-  if (!print_help) {
-    cerr << endl << "*** ";
-    
-    if (parameterfile == nullptr) {
-      cerr << "Parameter -p <parameter_file> is mandatory" << endl;
+  if (!query && o.parameterfile == nullptr) {
+    err << "Parameter -p <parameter_file> is mandatory" << endl;
+    print_help = true;
+  }
+
+  if (o.serve || o.socket != nullptr) {
+    if (o.serve && o.socket != nullptr) {
+      err << "Options -q and -Q are not compatible" << endl;
+      print_help = true;
+    }
+    if (o.compile || o.difficult != nullptr || o.champ != nullptr ||
+        o.rInstances != nullptr || o.ranks != nullptr ||
+        o.dominance != nullptr || o.profiles != nullptr ||
+        o.best != nullptr || o.grid != nullptr || o.tolerances != nullptr ||
+        o.output != nullptr || o.sweep != nullptr || o.scaling >= 0 ||
+        o.delta != nullptr || o.replicates != 0 || o.confidence >= 0 ||
+        o.absolute_values || o.level >= 0 || o.cMetric > 0 ||
+        o.summary != nullptr || o.predicate != nullptr ||
+        o.profile != nullptr || o.stream > 0) {
+      err << "Options -q and -Q only accept options -p and -t" << endl;
       print_help = true;
     }
+  }
 
-    if (level >= 0) {
-      if (difficult == nullptr) {
-        cerr << "Option -l requires option -d <file_name>" << endl;
-        print_help = true;
-      }
+  if (o.stream > 0 &&
+      (o.compile || o.delta != nullptr || o.difficult != nullptr ||
+       o.champ != nullptr || o.ranks != nullptr || o.profiles != nullptr ||
+       o.sweep != nullptr)) {
+    err << "Option -O is not compatible with options -b, -u, -d, -c, -k, -P "
+        << "and -S" << endl;
+    print_help = true;
+  }
+
+  if ((o.summary == nullptr) != (o.predicate == nullptr)) {
+    err << "Options -i <summary_file> and -f <predicate> go together" << endl;
+    print_help = true;
+  }
+
+  if (o.level >= 0) {
+    if (o.difficult == nullptr) {
+      err << "Option -l requires option -d <file_name>" << endl;
+      print_help = true;
     }
+  }
 
-    if (difficult != nullptr) {
-      if (scaling >= 0 || absolute_values) {
-        cerr << "Option -d is not compatible with options -s and -a" << endl;
-        print_help = true;
-      }
+  if (o.difficult != nullptr) {
+    if (o.scaling >= 0 || o.absolute_values) {
+      err << "Option -d is not compatible with options -s and -a" << endl;
+      print_help = true;
     }
+  }
+
+  if (o.rInstances != nullptr && o.champ == nullptr) {
+    err << "Option -r <file_name> requires option -c <algorithm>" << endl;
+    print_help = true;
+  }
+
+  if (o.rInstances == nullptr && o.champ != nullptr) {
+    err << "Option -c <algorithm> requires option -r <file_name>" << endl;
+    print_help = true;
+  }
 
-    if (rInstances != nullptr && champ == nullptr) {
-      cerr << "Option -r <file_name> requires option -c <algorithm>" << endl;
+  if (o.cMetric > 0) {
+    if (o.rInstances == nullptr || o.champ == nullptr) {
+      err << "Option -m requires options -c <algorithm> and -r <file_name>"
+          << endl;
       print_help = true;
     }
+  }
+
+  if (o.cMetric > 3) {
+      err << "<metric> value must be between 0 and 3" << endl;
+      print_help = true;
+  }
+
+  if (o.ranks != nullptr && (o.difficult != nullptr || o.sweep != nullptr)) {
+    err << "Option -k is not compatible with options -d and -S" << endl;
+    print_help = true;
+  }
+
+  if (o.dominance != nullptr &&
+      (o.difficult != nullptr || o.sweep != nullptr)) {
+    err << "Option -w is not compatible with options -d and -S" << endl;
+    print_help = true;
+  }
+
+  if (o.profiles != nullptr &&
+      (o.difficult != nullptr || o.sweep != nullptr)) {
+    err << "Option -P is not compatible with options -d and -S" << endl;
+    print_help = true;
+  }
 
-    if (rInstances == nullptr && champ != nullptr) {
-      cerr << "Option -c <algorithm> requires option -r <file_name>" << endl;
+  if (o.best != nullptr && (o.difficult != nullptr || o.sweep != nullptr)) {
+    err << "Option -V is not compatible with options -d and -S" << endl;
+    print_help = true;
+  }
+  if ((o.grid != nullptr || o.tolerances != nullptr) &&
+      o.profiles == nullptr) {
+    err << "Options -T and -e require option -P <file_name>" << endl;
+    print_help = true;
+  }
+  if (o.profiles != nullptr) {
+    if (!parse_scalings(o.grid != nullptr ? o.grid : "0.05:1:0.05",
+                        o.fractions, o.fraction_labels)) {
+      err << "Illegal list of time fractions " << o.grid << endl;
       print_help = true;
+    } else
+      for (double v : o.fractions)
+        if (v > 1.0 || v <= 0.0) {
+          err << "time fraction must be > 0 and <= 1.0" << endl;
+          print_help = true;
+          break;
+        }
+    if (!parse_scalings(o.tolerances != nullptr ? o.tolerances : "0",
+                        o.tolerance_values, o.tolerance_labels)) {
+      err << "Illegal list of tolerances " << o.tolerances << endl;
+      print_help = true;
+    } else
+      for (double v : o.tolerance_values)
+        if (v < 0.0) {
+          err << "tolerance must be >= 0" << endl;
+          print_help = true;
+          break;
+        }
+  }
+
+  if (o.replicates < 0) {
+    err << "<replicates> value must be >= 0" << endl;
+    print_help = true;
+  }
+
+  if (o.replicates > 0 && (o.difficult != nullptr || o.rInstances != nullptr)) {
+    err << "Option -B is not compatible with options -d and -r" << endl;
+    print_help = true;
+  }
+
+  if (o.confidence >= 0 && o.replicates <= 0) {
+    err << "Option -L requires option -B <replicates>" << endl;
+    print_help = true;
+  }
+  if (o.confidence < 0) o.confidence = 0.95;
+  if (o.confidence <= 0.0 || o.confidence >= 1.0) {
+    err << "confidence level must be > 0 and < 1.0" << endl;
+    print_help = true;
+  }
+
+  if (o.compile && o.delta != nullptr) {
+    err << "Options -b and -u are not compatible" << endl;
+    print_help = true;
+  }
+
+  if (o.output != nullptr &&
+      (o.difficult != nullptr || o.rInstances != nullptr)) {
+    err << "Option -o is not compatible with options -d and -r" << endl;
+    print_help = true;
+  }
+
+  if (o.sweep != nullptr) {
+    if (o.scaling >= 0 || o.difficult != nullptr || o.champ != nullptr) {
+      err << "Option -S is not compatible with options -s, -d and -c" << endl;
+      print_help = true;
+    } else if (!parse_scalings(o.sweep, o.scalings, o.scaling_labels)) {
+      err << "Illegal list of time scalings " << o.sweep << endl;
+      print_help = true;
+    } else
+      for (double v : o.scalings)
+        if (v > 1.0 || v <= 0.0) {
+          err << "time scaling must be > 0 and <= 1.0" << endl;
+          print_help = true;
+          break;
+        }
+  }
+
+  if (o.threads < 0) {
+    err << "<threads> value must be >= 0" << endl;
+    print_help = true;
+  }
+  if (o.threads == 0) o.threads = max(1u, thread::hardware_concurrency());
+
+  if (o.scaling < 0) o.scaling = 1.0;
+
+  if (o.scaling > 1.0 || o.scaling <= 0.0) {
+    err << "time scaling must be > 0 and <= 1.0" << endl;
+    print_help = true;
+  }
+  return !print_help;
+}
+
+//-------------------------------------------------------------------
+// Writes the help message of the program, whose name is tmp.
+void print_usage(ostream& err, const string& tmp) {
+  err << endl
+      << "Usage: " << tmp << " -p <parameter_file> "
+      << "[-s <time scaling>] [-a] " << endl;
+  err << string(tmp.length() + 8, ' ') << "[-d <file_name>] "
+      << "[-l <level>]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-c <algorithm> -r <file_name> "
+      << "[-m <metric>]]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-k <file_name>] "
+      << "[-w <file_name>] [-o <file_name>]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-S <time scalings>] "
+      << "[-V <file_name>]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-P <file_name> "
+      << "[-T <time fractions>] [-e <tolerances>]]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-b] [-t <threads>] "
+      << "[-u <file_name>]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-B <replicates> "
+      << "[-L <confidence>]]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-i <summary_file> "
+      << "-f <predicate>] [-j <file_name>]" << endl;
+  err << string(tmp.length() + 8, ' ') << "[-O <megabytes>] "
+      << "[-q | -Q <socket>]" << endl
+      << endl;
+  err << " -p <parametr_file> is mandatory" << endl;
+  err << " -s <time scaling> (>0 and <= 1.0) [default: 1.0]: all time limits"
+      << endl
+      << "    are scaled by this factor." << endl;
+  err << " -a flag [default: false]: statistics are made with absolute "
+      << "values" << endl
+      << "    rather than percentages." << endl;
+  err << " -d <file_name>: the names of all instances whose best value is "
+         "found"
+      << endl
+      << "    by at most <level> algorithms for all seed values are put to "
+         "this"
+      << endl
+      << "    file." << endl;
+  err << " -l <level> (>=0) [default: number of algorithms / 2])." << endl;
+  err << " -r <file_name>: the names of all instances where <algorithm>"
+      << " is best" << endl << "    in <metric> ranking." << endl;
+  err << " -c <algorithm> (no check is performed whether this is among"
+      << " the" << endl << "    algorithms in the results file)." << endl;
+  err << " -m <metric> (>=0 and <= 3) [default: 0]. 0:FE, 1:FS, 2:BA"
+      << " 3:EBA." << endl;
+  err << " -k <file_name>: the rank of every algorithm for each instance "
+      << "and seed" << endl
+      << "    is written to this file (one row per instance and seed)."
+      << endl;
+  err << " -w <file_name>: the number of instances where every algorithm "
+      << "beats," << endl
+      << "    ties and loses to every other one, by sum and by best value "
+      << "over" << endl
+      << "    the seeds, is written to this file (one row per pair)." << endl;
+  err << " -P <file_name>: for every algorithm, tolerance and fraction of "
+      << "the" << endl
+      << "    (scaled) time limits, the fraction of the runs whose value at "
+      << "that time" << endl
+      << "    is within the tolerance of the best value of the instance is "
+      << "written" << endl
+      << "    to this file (time-to-target distributions and performance "
+      << "profiles)." << endl;
+  err << " -V <file_name>: the best known value of every instance, its "
+      << "earliest" << endl
+      << "    time, the algorithm and seed reaching it and the number of "
+      << "algorithms" << endl
+      << "    reaching it are written to this file, and in binary form to"
+      << endl
+      << "    <file_name>.idx (see best_known.h), unless the file is \"-\"."
+      << endl;
+  err << " -T <time fractions> [default: 0.05:1:0.05]: the fractions of the "
+      << "time" << endl
+      << "    limits of option -P (>0 and <= 1.0), in the format of -S."
+      << endl;
+  err << " -e <tolerances> [default: 0]: the relative tolerances of option "
+      << "-P" << endl
+      << "    (>=0), in the format of -S." << endl;
+  err << " -S <time scalings>: list of time scalings separated by ','; "
+      << "each element" << endl
+      << "    is a scaling or a range <first>:<last>:<step>. The table is "
+      << "computed" << endl
+      << "    for every scaling and all tables are written to the output "
+      << "file," << endl
+      << "    whose first column is the scaling." << endl;
+  err << " -o <file_name>: the statistics are written to this file "
+      << "instead of" << endl
+      << "    the output file of the parameter file; \"-\" stands for the "
+      << "standard" << endl
+      << "    output (for the client in server mode). The names of the "
+      << "files of" << endl
+      << "    options -d, -r, -k, -w, -P and -V can be \"-\" as well; the "
+      << "messages of" << endl
+      << "    the program are then written to the standard error." << endl;
+  err << " -b flag: compile the results file into the binary cache"
+      << endl
+      << "    <results file>.cache and exit. The cache is used in place of"
+      << endl
+      << "    the results file as long as the latter is not modified."
+      << endl;
+  err << " -t <threads> (>=0) [default: 0]: the results file is parsed and"
+      << " the" << endl
+      << "    statistics are computed by this number of threads; 0 stands "
+      << "for the" << endl
+      << "    number of hardware threads." << endl;
+  err << " -u <file_name>: the runs of this results file are merged into "
+      << "the" << endl
+      << "    results file and its binary cache before the statistics are "
+      << "computed;" << endl
+      << "    only this file is parsed. In a query, the loaded results are "
+      << "updated" << endl
+      << "    as well. If the file has an invalid number, nothing is merged."
+      << endl;
+  err << " -B <replicates> (>=0) [default: 0]: the table gets the bounds of "
+      << "the" << endl
+      << "    bootstrap confidence intervals of all statistics, computed "
+      << "with this" << endl
+      << "    number of resamples of the instances, as columns "
+      << "<statistic>_low" << endl
+      << "    and <statistic>_high." << endl;
+  err << " -L <confidence> (>0 and <1.0) [default: 0.95]: the level of the "
+      << "confidence" << endl
+      << "    intervals of option -B." << endl;
+  err << " -i <summary_file> -f <predicate>: only the instances of the "
+      << "summary file" << endl
+      << "    satisfying the predicate are analyzed, e.g. \"density < 0.1 "
+      << "&& n >= 1000\"" << endl
+      << "    (see extract); in a query, the predicate must not contain "
+      << "blanks." << endl;
+  err << " -j <file_name>: the wall time and calls of every stage, the "
+      << "bytes read," << endl
+      << "    the records parsed and skipped, the history entries scanned "
+      << "and the" << endl
+      << "    peak memory are appended to this file as one JSON line "
+      << "(\"-\" stands for" << endl
+      << "    the standard output)." << endl;
+  err << " -O <megabytes> (>0): streaming mode. The results file is read "
+      << "once, by" << endl
+      << "    chunks, the value and time of its runs are kept in a temporary "
+      << "file, and" << endl
+      << "    they are reduced by blocks of instances whose results take at "
+      << "most this" << endl
+      << "    memory; only the reductions of the statistics are kept. Not "
+      << "with -b," << endl
+      << "    -u, -d, -c, -k, -P and -S." << endl;
+  err << " -q flag: server mode. The results file is loaded once and the "
+      << "queries" << endl
+      << "    read from the standard input, one per line, are answered. A "
+      << "query" << endl
+      << "    is made of the options above but -p, -b, -t, -j, -q, -Q "
+      << "and -O; its" << endl
+      << "    answer ends with a line \"OK\" or \"ERROR: <message>\". The "
+      << "query" << endl
+      << "    \"quit\" stops the server." << endl;
+  err << " -Q <socket>: server mode, with the queries read from the "
+      << "clients of the" << endl
+      << "    Unix domain socket <socket>." << endl;
+  err << endl;
+}
+
+//-------------------------------------------------------------------
+// Destination of an output: the file with the given name or, if the name is
+// "-", the stream standard.
+class Output {
+ public:
+  bool open(const char* name, ostream& standard) {
+    if (string(name) == "-") {
+      stream = &standard;
+      return true;
     }
+    file.open(name);
+    stream = &file;
+    return file.is_open();
+  }
+  ostream& get() { return *stream; }
+
+ private:
+  ofstream file;
+  ostream* stream = nullptr;
+};
+
+//-------------------------------------------------------------------
+// Writes the outputs requested by options, computed from the results loaded
+// by TB; the outputs named "-" are written to out.  Returns false, after
+// writing the error to err, if an output cannot be created.
+bool run_query(tablegenerator& TB, const Options& options, ostream& out,
+               ostream& err) {
+  const Options& o = options;
+  auto open = [&](Output& output, const char* name) {
+    if (output.open(name, out)) return true;
+    err << "Cannot create file " << name << endl;
+    return false;
+  };
+  Output stat, aux;
+  TB.bootstrap_replicates = o.replicates;
+  TB.bootstrap_confidence = o.confidence;
+  if (o.difficult != nullptr) {
+    if (!open(aux, o.difficult)) return false;
+    TB.extract(o.level, aux.get());
+    return true;
+  }
+  if (o.rInstances != nullptr && !TB.has_algorithm(o.champ)) {
+    err << "Algorithm " << o.champ << " does not exist!" << endl;
+    return false;
+  }
+  if (o.sweep != nullptr) {
+    if (!open(stat, o.output != nullptr ? o.output
+                                        : TB.statistics_file().c_str()))
+      return false;
+    TB.sweep(o.scalings, o.scaling_labels, stat.get());
+    return true;
+  }
+  TB.UpdateStatistics();
+  if (o.ranks != nullptr) {
+    if (!open(aux, o.ranks)) return false;
+    TB.write_ranks(aux.get());
+  }
+  if (o.dominance != nullptr) {
+    Output dominance;
+    if (!open(dominance, o.dominance)) return false;
+    TB.write_dominance(dominance.get());
+  }
+  if (o.profiles != nullptr) {
+    Output profiles;
+    if (!open(profiles, o.profiles)) return false;
+    TB.write_profiles(o.fractions, o.fraction_labels, o.tolerance_values,
+                      o.tolerance_labels, profiles.get());
+  }
+  if (o.best != nullptr) {
+    Output best;
+    if (!open(best, o.best)) return false;
+    BestKnownIndex index;
+    TB.best_known(index);
+    index.write_csv(best.get());
+    string indexname = BestKnownIndex::index_name(o.best);
+    if (string(o.best) == "-") {
+      cout << "WARNING: With -V -, the best known values are written in "
+           << "CSV only, without their binary index" << endl;
+    } else if (!index.write_index(indexname, TB.results_file())) {
+      err << "Cannot create file " << indexname << endl;
+      return false;
+    }
+  }
+  if (o.rInstances != nullptr) {
+    Output champ;
+    if (!open(champ, o.rInstances)) return false;
+    TB.extractChamp(o.cMetric, o.champ, champ.get());
+  } else {
+    if (!open(stat, o.output != nullptr ? o.output
+                                        : TB.statistics_file().c_str()))
+      return false;
+    TB.writetable(stat.get());
+  }
+  return true;
+}
+
+//-------------------------------------------------------------------
+// Stream buffer reading and writing a file descriptor, used to talk to the
+// clients of the server.
+class FdBuf : public streambuf {
+ public:
+  explicit FdBuf(int fd) : fd(fd) {
+    setg(in, in, in);
+    setp(out, out + sizeof(out));
+  }
+  ~FdBuf() override { sync(); }
+
+ protected:
+  int_type underflow() override {
+    ssize_t n;
+    do n = read(fd, in, sizeof(in));
+    while (n < 0 && errno == EINTR);
+    if (n <= 0) return traits_type::eof();
+    setg(in, in, in + n);
+    return traits_type::to_int_type(in[0]);
+  }
+  int_type overflow(int_type c) override {
+    if (sync() != 0) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+  int sync() override {
+    for (char* p = pbase(); p < pptr();) {
+      ssize_t n = write(fd, p, pptr() - p);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return -1;
+      p += n;
+    }
+    setp(out, out + sizeof(out));
+    return 0;
+  }
+
+ private:
+  int fd;
+  char in[1 << 16];
+  char out[1 << 16];
+};
+
+//-------------------------------------------------------------------
+// Server mode: the results file is loaded once and kept in memory, together
+// with the statistics of the last query, to answer the queries read one per
+// line.  A query is made of the options of the command line (those about
+// the selection of the results excepted), separated by blanks; its answer is
+// the messages of the program and the outputs named "-", followed by a line
+// "OK" or "ERROR: <message>".  The line "quit" stops the server.
+class QueryServer {
+ public:
+  explicit QueryServer(const tablegenerator& tb) : proto(tb), TB(tb) {
+    TB.read_selected_instances();
+    TB.read_selected_algorithms();
+    TB.read_results_file();
+  }
 
-    if (cMetric > 0) {
-      if (rInstances == nullptr || champ == nullptr) {
-        cerr << "Option -m requires options -c <algorithm> and -r <file_name>"
-	     << endl;
-        print_help = true;
+  // Answers the queries read from in, writing the answers to out.  Returns
+  // false if the server must be stopped.
+  bool serve(istream& in, ostream& out) {
+    string line;
+    while (getline(in, line)) {
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      istringstream words(line);
+      vector<string> args{"query"};
+      for (string w; words >> w;) args.push_back(w);
+      if (args.size() == 1 || args[1][0] == '#') continue;
+      if (args.size() == 2 && args[1] == "quit") return false;
+      vector<char*> argv;
+      for (string& a : args) argv.push_back(a.data());
+      argv.push_back(nullptr);
+
+      Options query;
+      ostringstream err;
+      if (!parse_options(args.size(), argv.data(), query, err, true)) {
+        if (err.str().empty()) {
+          print_usage(out, "query");
+          out << "OK" << endl;
+        } else
+          out << "ERROR: " << one_line(err.str()) << endl;
+        continue;
       }
+      if (query.delta != nullptr) {
+        if (!ifstream(query.delta).is_open()) {
+          out << "ERROR: File " << query.delta << " does not exist" << endl;
+          continue;
+        }
+        string error;
+        if (!TB.append_results_file(query.delta, error)) {
+          out << "ERROR: " << one_line(error) << endl;
+          continue;
+        }
+        all_instances.reset();  // its runs are replayed at the next query
+        subset.reset();
+      }
+      tablegenerator* g = generator(query, err);
+      if (g == nullptr) {
+        out << "ERROR: " << one_line(err.str()) << endl;
+        continue;
+      }
+      tablegenerator& G = *g;
+      G.absolute_values = query.absolute_values;
+      if (query.difficult == nullptr && query.sweep == nullptr)
+        G.rescale(query.scaling);
+      if (run_query(G, query, out, err))
+        out << "OK" << endl;
+      else
+        out << "ERROR: " << one_line(err.str()) << endl;
     }
+    return true;
+  }
 
-    if (cMetric > 3) {
-        cerr << "<metric> value must be between 0 and 3" << endl;
-        print_help = true;
+  // Answers the queries of the clients connecting to the Unix domain socket
+  // path, one client at a time.  Returns false if the socket cannot be
+  // created.
+  bool serve_socket(const char* path) {
+    sockaddr_un addr{};
+    if (strlen(path) >= sizeof(addr.sun_path)) return false;
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    unlink(path);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 8) != 0) {
+      close(fd);
+      return false;
     }
-    
-    if (scaling < 0) scaling = 1.0;
+    signal(SIGPIPE, SIG_IGN);  // clients may leave before their answer
+    cout << "Listening on " << path << endl;
+    bool go_on = true;
+    while (go_on) {
+      int client = accept(fd, nullptr, nullptr);
+      if (client < 0) {
+        if (errno == EINTR) continue;
+        break;
+      }
+      {
+        FdBuf buf(client);
+        iostream stream(&buf);
+        // the messages of the program are sent to the client as well
+        streambuf* old = cout.rdbuf(&buf);
+        go_on = serve(stream, stream);
+        stream.flush();
+        cout.rdbuf(old);
+      }
+      close(client);
+    }
+    close(fd);
+    unlink(path);
+    return true;
+  }
 
-    if (scaling > 1.0 || scaling <= 0.0) {
-      cerr << "time scaling must be > 0 and <= 1.0" << endl;
-      print_help = true;
+ private:
+  tablegenerator proto;  // the parameters, before any results are loaded
+  tablegenerator TB;     // the results selected by the parameter file
+  // the results of all instances, for the difficult instances (option -d),
+  // loaded at the first such query
+  unique_ptr<tablegenerator> all_instances;
+  // the results of the instances selected by the last query with option -f,
+  // described by subset_key, and the summary files loaded so far
+  unique_ptr<tablegenerator> subset;
+  string subset_key;
+  unordered_map<string, shared_ptr<InstanceSummary>> summaries;
+
+  // The generator of the results of a query, or nullptr, after writing the
+  // error to err, if its instances cannot be selected.
+  tablegenerator* generator(const Options& query, ostream& err) {
+    if (query.predicate != nullptr) {
+      string key = string(query.difficult != nullptr ? "d" : "-") +
+                   query.summary + '\n' + query.predicate;
+      if (subset != nullptr && subset_key == key) return subset.get();
+      subset.reset();
+      shared_ptr<InstanceSummary>& summary = summaries[query.summary];
+      if (summary == nullptr) summary = load_summary(query.summary, false);
+      if (summary == nullptr) {
+        summaries.erase(query.summary);
+        err << "File " << query.summary << " does not exist" << endl;
+        return nullptr;
+      }
+      auto g = make_unique<tablegenerator>(proto);
+      if (query.difficult != nullptr) g->Set_instances_set();
+      if (!g->filter_instances(summary, query.predicate, err)) return nullptr;
+      g->read_selected_instances();
+      g->read_selected_algorithms();
+      g->share_results(TB);
+      g->read_results_file();
+      subset = move(g);
+      subset_key = key;
+      return subset.get();
+    }
+    if (query.difficult == nullptr) return &TB;
+    if (all_instances == nullptr) {
+      all_instances = make_unique<tablegenerator>(proto);
+      all_instances->Set_instances_set();
+      all_instances->read_selected_instances();
+      all_instances->read_selected_algorithms();
+      all_instances->share_results(TB);
+      all_instances->read_results_file();
     }
+    return all_instances.get();
+  }
+
+  // The lines of the messages in s, on a single line.
+  static string one_line(const string& s) {
+    string line;
+    istringstream lines(s);
+    for (string l; getline(lines, l);)
+      if (!l.empty()) line += (line.empty() ? "" : "; ") + l;
+    return line;
+  }
+};
+
+//-------------------------------------------------------------------
+// Appends the profile of the run to file name ("-" for out), if any.
+void write_profile(const char* name, const char* program, ostream& out) {
+  if (name == nullptr) return;
+  if (strcmp(name, "-") == 0) {
+    profiler.write_json(out, program);
+    return;
+  }
+  ofstream fout(name, ios::app);
+  if (fout.is_open()) profiler.write_json(fout, program);
+  if (!fout) {
+    cerr << "Cannot create file " << name << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+//-------------------------------------------------------------------
+int main(int argc, char** argv) {
+  Options options;
+  bool print_help = argc == 1;
+  if (!print_help) {
+    ostringstream err;
+    print_help = !parse_options(argc, argv, options, err, false);
+    if (!err.str().empty()) cerr << endl << "*** " << err.str();
   }
   if (print_help) {
-    string tmp(argv[0]);
-    cerr << endl
-         << "Usage: " << argv[0] << " -p <parameter_file> "
-         << "[-s <time scaling>] [-a] " << endl;
-    cerr << string(tmp.length() + 8, ' ') << "[-d <file_name>] "
-         << "[-l <level>]" << endl;
-    cerr << string(tmp.length() + 8, ' ') << "[-c <algorithm> -r <file_name> "
-         << "[-m <metric>]]" << endl
-         << endl;
-    cerr << " -p <parametr_file> is mandatory" << endl;
-    cerr << " -s <time scaling> (>0 and <= 1.0) [default: 1.0]: all time limits"
-         << endl
-         << "    are scaled by this factor." << endl;
-    cerr
-        << " -a flag [default: false]: statistics are made with absolute values"
-        << endl
-        << "    rather than percentages." << endl;
-    cerr << " -d <file_name>: the names of all instances whose best value is "
-            "found"
-         << endl
-         << "    by at most <level> algorithms for all seed values are put to "
-            "this"
-         << endl
-         << "    file." << endl;
-    cerr << " -l <level> (>=0) [default: number of algorithms / 2])." << endl;
-    cerr << " -r <file_name>: the names of all instances where <algorithm>"
-	 << " is best" << endl << "    in <metric> ranking." << endl;
-    cerr << " -c <algorithm> (no check is performed whether this is among"
-	 << " the" << endl << "    algorithms in the results file)." << endl;
-    cerr << " -m <metric> (>=0 and <= 3) [default: 0]. 0:FE, 1:FS, 2:BA"
-	 << " 3:EBA." << endl;
-    cerr << endl;
+    print_usage(cerr, argv[0]);
     exit(EXIT_FAILURE);
   }
+  if (options.profile != nullptr) {
+    profiler.enabled = true;
+    profiler.start();
+  }
+  // The outputs named "-" are written to the standard output alone, so
+  // that they can be piped: the messages of the program are then written
+  // to the standard error.  In server mode they are part of the answers.
+  ostream out(cout.rdbuf());
+  if (!options.serve && options.socket == nullptr &&
+      options.writes_standard_output())
+    cout.rdbuf(cerr.rdbuf());
 
   tablegenerator TB;
-  TB.time_limit_scaling = scaling;
-  TB.read_parameters(parameterfile);
-  if (difficult != nullptr) TB.Set_instances_set();
+  TB.time_limit_scaling = options.scaling;
+  TB.n_threads = options.threads;
+  TB.read_parameters(options.parameterfile);
+  string error;
+  if (options.delta != nullptr &&
+      !TB.append_results_file(options.delta, error)) {
+    cerr << error << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (options.compile) {
+    TB.compile_results_file();
+    write_profile(options.profile, "tablegenerator", out);
+    return EXIT_SUCCESS;
+  }
+  if (options.serve || options.socket != nullptr) {
+    TB.absolute_values = false;
+    QueryServer server(TB);
+    cout << "END OF INPUT " << endl;
+    if (options.serve) {
+      server.serve(cin, cout);
+    } else if (!server.serve_socket(options.socket)) {
+      cerr << "Cannot listen on socket " << options.socket << endl;
+      exit(EXIT_FAILURE);
+    }
+    return EXIT_SUCCESS;
+  }
+  if (options.difficult != nullptr) TB.Set_instances_set();
+  if (options.predicate != nullptr) {
+    shared_ptr<InstanceSummary> summary = load_summary(options.summary, true);
+    if (summary == nullptr) {
+      cerr << "File " << options.summary << " does not exist" << endl;
+      exit(EXIT_FAILURE);
+    }
+    ostringstream err;
+    if (!TB.filter_instances(summary, options.predicate, err)) {
+      cerr << "*** " << err.str();
+      exit(EXIT_FAILURE);
+    }
+  }
   TB.read_selected_instances();
   TB.read_selected_algorithms();
-  TB.read_results_file();
-  TB.absolute_values = absolute_values;
+  if (options.stream > 0) {
+    TB.stream_budget = static_cast<size_t>(options.stream) << 20;
+    TB.stream_results_file();
+  } else {
+    TB.read_results_file();
+  }
+  TB.absolute_values = options.absolute_values;
 
   cout << "END OF INPUT " << endl;
 
-  if (difficult != nullptr)
-    TB.extract(level, difficult);
-  else {
-    cout << "START STATISTICS" << endl;
-    TB.ComputeStatistics();
-    if (rInstances != nullptr)
-      TB.extractChamp(cMetric, champ, rInstances);
-    else
-      TB.writetable();
-    cout << "END STATISTICS" << endl;
+  ostringstream err;
+  if (options.difficult == nullptr) cout << "START STATISTICS" << endl;
+  if (!run_query(TB, options, out, err)) {
+    cerr << "*** " << err.str();
+    exit(EXIT_FAILURE);
   }
+  if (options.difficult == nullptr) cout << "END STATISTICS" << endl;
+  write_profile(options.profile, "tablegenerator", out);
   return EXIT_SUCCESS;
 }
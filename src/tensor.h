@@ -0,0 +1,75 @@
+/**
+ * @file tensor.h
+ * @brief Dense three-dimensional array stored in a single contiguous block.
+ *
+ * Tensor3<T> holds n1 x n2 x n3 elements in row-major order: element
+ * (i, j, k) is at position (i * n2 + j) * n3 + k.  tablegenerator stores the
+ * results as instance x algorithm x seed tensors, so that the n_seeds
+ * results of an algorithm on an instance are contiguous, and all the results
+ * of an instance form a contiguous block of nalgorithms x n_seeds elements.
+**/
+
+#ifndef TENSOR_H
+#define TENSOR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+template <class T>
+class Tensor3 {
+ public:
+  Tensor3() = default;
+  Tensor3(std::size_t n1, std::size_t n2, std::size_t n3, const T& v = T()) {
+    assign(n1, n2, n3, v);
+  }
+
+  // Resizes the tensor to n1 x n2 x n3 and sets all elements to v.
+  void assign(std::size_t n1, std::size_t n2, std::size_t n3,
+              const T& v = T()) {
+    d1 = n1;
+    d2 = n2;
+    d3 = n3;
+    elems.assign(n1 * n2 * n3, v);
+  }
+
+  // Resizes the tensor to n1 x n2 x n3, keeping the elements whose indices
+  // are within both the old and the new dimensions; the other ones are set
+  // to v.
+  void resize(std::size_t n1, std::size_t n2, std::size_t n3,
+              const T& v = T()) {
+    Tensor3 t(n1, n2, n3, v);
+    for (std::size_t i = 0; i < d1 && i < n1; ++i)
+      for (std::size_t j = 0; j < d2 && j < n2; ++j)
+        for (std::size_t k = 0; k < d3 && k < n3; ++k)
+          t(i, j, k) = (*this)(i, j, k);
+    *this = std::move(t);
+  }
+
+  std::size_t dim1() const { return d1; }
+  std::size_t dim2() const { return d2; }
+  std::size_t dim3() const { return d3; }
+
+  T& operator()(std::size_t i, std::size_t j, std::size_t k) {
+    return elems[(i * d2 + j) * d3 + k];
+  }
+  const T& operator()(std::size_t i, std::size_t j, std::size_t k) const {
+    return elems[(i * d2 + j) * d3 + k];
+  }
+
+  // The dim3() contiguous elements (i, j, 0), ..., (i, j, dim3() - 1).
+  T* row(std::size_t i, std::size_t j) { return &elems[(i * d2 + j) * d3]; }
+  const T* row(std::size_t i, std::size_t j) const {
+    return &elems[(i * d2 + j) * d3];
+  }
+
+  T* data() { return elems.data(); }
+  const T* data() const { return elems.data(); }
+  std::size_t size() const { return elems.size(); }
+
+ private:
+  std::size_t d1 = 0, d2 = 0, d3 = 0;
+  std::vector<T> elems;
+};
+
+#endif  // TENSOR_H
@@ -0,0 +1,748 @@
+#!/bin/bash
+#
+# Regression tests of the programs on small hand-made inputs.
+#
+# Usage: run_tests.sh <build_dir>
+#
+# Every test runs the binaries of <build_dir> in a temporary directory and
+# prints "PASS <test>" or "FAIL <test>" with the difference from the
+# expected output; the script exits with status 1 if any test fails.
+
+if [ $# -ne 1 ]; then
+  echo "Usage: $0 <build_dir>" >&2
+  exit 1
+fi
+BIN=$(cd "$1" && pwd)
+
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/tests.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK"
+
+failed=0
+
+# Compares file $2 with the expected text on standard input for test $1.
+expect() {
+  if diff <(cat) "$2" > diff.txt; then
+    echo "PASS $1"
+  else
+    echo "FAIL $1"
+    cat diff.txt
+    failed=1
+  fi
+}
+
+# Writes the names of algorithms alg0, ..., alg<$1 - 1>.
+alg_names() {
+  mkdir -p data
+  for a in $(seq 0 $(($1 - 1))); do echo "alg$a,Algorithm $a"; done \
+    > data/Alg_names.csv
+}
+
+#-------------------------------------------------------------------
+# tablegenerator: FS when all the values are negative, the runner-up of
+# every instance being smaller than the winner.
+alg_names 3
+cat > neg.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,-10,1,-10:1;
+2024-01-01,inst0,alg1,0,10,-20,1,-20:1;
+2024-01-01,inst0,alg2,0,10,-30,1,-30:1;
+2024-01-01,inst1,alg0,0,10,-5,1,-5:1;
+2024-01-01,inst1,alg1,0,10,-7,1,-7:1;
+2024-01-01,inst1,alg2,0,10,-7,1,-7:1;
+END
+echo "neg.csv all_instances all_algorithms neg_table.csv" > neg.txt
+"$BIN/tablegenerator" -p neg.txt > /dev/null 2>&1
+expect tablegenerator.negative_fs neg_table.csv <<'END'
+Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR
+Algorithm 0,100.0,100.0,100.0,100.0,100.00,100.00,100.00,1.0
+Algorithm 1,0.0,0.0,0.0,0.0,100.00,100.00,100.00,2.0
+Algorithm 2,0.0,0.0,0.0,0.0,100.00,100.00,100.00,2.5
+END
+"$BIN/tablegenerator" -p neg.txt -s 1 -c alg0 -r champ.txt -m 1 > /dev/null 2>&1
+expect tablegenerator.negative_champ champ.txt <<'END'
+inst0
+inst1
+END
+
+# tablegenerator: -V writes the best known values in CSV and in the binary
+# index of best_known.h, whose values are plain doubles.
+"$BIN/tablegenerator" -p neg.txt -V best.csv > /dev/null 2>&1
+read -r -a off < <(od -A n -t u8 -w72 -j 48 -N 72 best.csv.idx)
+{
+  cat best.csv
+  head -c 8 best.csv.idx; echo
+  od -A n -t f8 -j "${off[6]}" -N 16 best.csv.idx | tr -s ' '
+  od -A n -t u4 -j "${off[8]}" -N 8 best.csv.idx | tr -s ' '
+} > best.txt
+expect tablegenerator.best_known best.txt <<'END'
+Instance,BestValue,Time,Algorithm,Seed,Reached
+inst0,-10,1,alg0,0,1
+inst1,-5,1,alg0,0,1
+TGBESTKN
+ -10 -5
+ 1 1
+END
+
+# tablegenerator: with -V -, the CSV goes to the standard output and a
+# warning tells that the binary index is not written.
+"$BIN/tablegenerator" -p neg.txt -V - 2> best_err.txt > best_out.txt
+grep WARNING best_err.txt >> best_out.txt
+expect tablegenerator.best_known_stdout best_out.txt <<'END'
+Instance,BestValue,Time,Algorithm,Seed,Reached
+inst0,-10,1,alg0,0,1
+inst1,-5,1,alg0,0,1
+WARNING: With -V -, the best known values are written in CSV only, without their binary index
+END
+
+# tablegenerator: with -o -, the standard output holds the table alone.
+"$BIN/tablegenerator" -p neg.txt -o - 2> /dev/null > stdout.txt
+expect tablegenerator.table_to_stdout stdout.txt < neg_table.csv
+
+# tablegenerator: a query "-u" with an invalid number is answered with an
+# error, the results file is unchanged and the server goes on.
+cp neg.csv base.csv
+echo "base.csv all_instances all_algorithms base_table.csv" > base.txt
+cat > delta.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst2,alg0,0,10,-3,1,-3:1;
+2024-01-01,inst2,alg1,0,10,x,1,-4:1;
+END
+printf -- "-u delta.csv\n-a\nquit\n" |
+  "$BIN/tablegenerator" -p base.txt -q 2> /dev/null | grep '^OK\|^ERROR' > server.txt
+cmp -s neg.csv base.csv || echo "base.csv modified" >> server.txt
+expect tablegenerator.server_bad_delta server.txt <<'END'
+ERROR: Error at line 3) invalid number x
+OK
+END
+
+# tablegenerator: with -s, the profiles of -P are at fractions of the scaled
+# time limits, those of the best values: at fraction 1, alg0 has not yet
+# reached the value it finds at time 8.
+alg_names 2
+cat > scaled.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,10,8,;5:1;10:8;
+2024-01-01,inst0,alg1,0,10,8,2,;8:2;
+END
+echo "scaled.csv all_instances all_algorithms scaled_table.csv" > scaled.txt
+"$BIN/tablegenerator" -p scaled.txt -s 0.5 -T 0.5,1 -P profiles.csv \
+  > /dev/null 2>&1
+expect tablegenerator.scaled_profiles profiles.csv <<'END'
+Heuristic,Tolerance,Time,Fraction
+Algorithm 0,0,0.5,0.0000
+Algorithm 0,0,1,0.0000
+Algorithm 1,0,0.5,1.0000
+Algorithm 1,0,1,1.0000
+END
+
+# tablegenerator: the values are compared exactly, whatever their notation:
+# -1e1 and -10.000 are equal and above -10.00000000000000000001, 2.5E-1
+# and 0.25 are equal and below 0.2500000000000000001.
+alg_names 3
+cat > dec.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,-1e1,1,-1e1:1;
+2024-01-01,inst0,alg1,0,10,-10.000,1,-10.000:1;
+2024-01-01,inst0,alg2,0,10,-10.00000000000000000001,1,-10.00000000000000000001:1;
+2024-01-01,inst1,alg0,0,10,2.5E-1,1,2.5E-1:1;
+2024-01-01,inst1,alg1,0,10,0.25,1,0.25:1;
+2024-01-01,inst1,alg2,0,10,0.2500000000000000001,1,0.2500000000000000001:1;
+END
+echo "dec.csv all_instances all_algorithms dec_table.csv" > dec.txt
+"$BIN/tablegenerator" -p dec.txt -V dec_best.csv -k dec_ranks.csv \
+  > /dev/null 2>&1
+cut -d, -f1,4,5 dec_table.csv | cat - dec_best.csv dec_ranks.csv > decimal.txt
+expect tablegenerator.exact_decimals decimal.txt <<'END'
+Heuristic,BA,EBA
+Algorithm 0,50.0,50.0
+Algorithm 1,50.0,50.0
+Algorithm 2,50.0,50.0
+Instance,BestValue,Time,Algorithm,Seed,Reached
+inst0,-10,1,alg0,0,2
+inst1,0.2500000000000000001,1,alg2,0,1
+Instance,Seed,alg0,alg1,alg2
+inst0,0,1,1,3
+inst1,0,2,2,1
+END
+
+# tablegenerator: a value with more than 38 significant digits is rounded
+# to 38 of them, half up, instead of being rejected.
+third=0.333333333333333333333333333333333333333333333
+cat > long.csv <<END
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,$third,1,$third:1;
+2024-01-01,inst0,alg1,0,10,${third:0:42},1,${third:0:42}:1;
+2024-01-01,inst0,alg2,0,10,${third:0:39}4,1,${third:0:39}4:1;
+END
+echo "long.csv all_instances all_algorithms long_table.csv" > long.txt
+"$BIN/tablegenerator" -p long.txt -V long_best.csv -k long_ranks.csv \
+  > /dev/null 2>&1
+cat long_best.csv long_ranks.csv > long.txt
+expect tablegenerator.long_decimals long.txt <<'END'
+Instance,BestValue,Time,Algorithm,Seed,Reached
+inst0,0.33333333333333333333333333333333333334,1,alg2,0,1
+Instance,Seed,alg0,alg1,alg2
+inst0,0,2,2,1
+END
+
+# tablegenerator: the binary cache of -b gives the table of the results
+# file, and it is not used once the results file has changed.
+cp dec_table.csv text_table.csv
+{
+  "$BIN/tablegenerator" -p dec.txt -b 2> /dev/null
+  "$BIN/tablegenerator" -p dec.txt 2> /dev/null | grep 'binary cache'
+  cmp -s text_table.csv dec_table.csv || echo "dec_table.csv differs"
+  echo "2024-01-01,inst1,alg0,1,10,1,1,1:1;" >> dec.csv
+  "$BIN/tablegenerator" -p dec.txt 2> /dev/null | grep 'binary cache'
+  cut -d, -f1,4 dec_table.csv
+} > cache.txt
+expect tablegenerator.binary_cache cache.txt <<'END'
+Compiled 6 records of dec.csv into dec.csv.cache
+Using binary cache dec.csv.cache
+Heuristic,BA
+Algorithm 0,100.0
+Algorithm 1,50.0
+Algorithm 2,50.0
+END
+
+# tablegenerator: the display names are read from the file given as the
+# last field of the parameter file; the binary cache keeps the name of the
+# file they come from, so another file of the same size and time is read.
+cat > names.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,2,1,2:1;
+2024-01-01,inst0,alg1,0,10,1,1,1:1;
+END
+echo "alg0,First 0" > first.csv; echo "alg1,First 1" >> first.csv
+echo "alg0,Other 0" > other.csv; echo "alg1,Other 1" >> other.csv
+touch -r first.csv other.csv
+echo "names.csv all_instances all_algorithms names_table.csv first.csv" \
+  > first.txt
+echo "names.csv all_instances all_algorithms names_table.csv other.csv" \
+  > other.txt
+{
+  "$BIN/tablegenerator" -p first.txt -b > /dev/null 2>&1
+  "$BIN/tablegenerator" -p other.txt 2> /dev/null | grep 'binary cache'
+  cut -d, -f1 names_table.csv
+  "$BIN/tablegenerator" -p first.txt > /dev/null 2>&1
+  cut -d, -f1 names_table.csv
+} > names.txt
+expect tablegenerator.display_names_file names.txt <<'END'
+Using binary cache names.csv.cache
+Heuristic
+Other 0
+Other 1
+Heuristic
+First 0
+First 1
+END
+
+# tablegenerator: the streaming mode gives the table and the best known
+# values of the results in memory.  With -O 1, the 2000 seeds of every
+# instance make blocks of one instance; runs are missing, and some appear
+# twice, the last one counting.
+alg_names 4
+awk 'BEGIN {
+  print "timestamp,graphname,algorithm,seed,timelimit,objective,time,history"
+  for (i = 0; i < 3; i++)
+    for (s = 0; s < 2000; s++)
+      for (a = 0; a < 4; a++) {
+        if ((i + s + a) % 97 == 0) continue
+        v = (i * 7 + s * 31 + a * 13) % 17
+        printf "2024-01-01,inst%d,alg%d,%d,10,%d,%d,%d:%d;\n", \
+          i, a, s, v, a + 1, v, a + 1
+      }
+  for (s = 0; s < 2000; s += 3)
+    printf "2024-01-01,inst1,alg2,%d,10,20,1,20:1;\n", s
+}' > big.csv
+echo "big.csv all_instances all_algorithms big_table.csv" > big.txt
+"$BIN/tablegenerator" -p big.txt -V big_best.csv > /dev/null 2>&1
+mv big_table.csv mem_table.csv
+mv big_best.csv mem_best.csv
+"$BIN/tablegenerator" -p big.txt -O 1 -V big_best.csv > /dev/null 2>&1
+{
+  cmp -s mem_table.csv big_table.csv || echo "big_table.csv differs"
+  cmp -s mem_best.csv big_best.csv || echo "big_best.csv differs"
+  cat big_table.csv
+} > stream.txt
+expect tablegenerator.streaming stream.txt <<'END'
+Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR
+Algorithm 2,33.3,33.3,100.0,33.3,100.00,47.12,0.00,2.4
+Algorithm 3,33.3,33.3,66.7,0.0,100.00,53.80,6.67,2.6
+Algorithm 0,33.3,33.3,66.7,66.7,100.00,53.82,6.67,2.5
+Algorithm 1,0.0,0.0,66.7,0.0,100.00,53.82,6.67,2.6
+END
+
+# tablegenerator: -S gives for every scaling the table of -s; at half the
+# time limits, the values are those of the histories at time 5.
+alg_names 3
+cat > mix.csv <<'END'
+timestamp,graphname,algorithm,seed,timelimit,objective,time,history
+2024-01-01,inst0,alg0,0,10,5,8,;3:2;5:8;
+2024-01-01,inst0,alg0,1,10,4,3,;4:3;
+2024-01-01,inst0,alg1,0,10,5,4,;5:4;
+2024-01-01,inst0,alg1,1,10,5,9,;2:1;5:9;
+2024-01-01,inst0,alg2,0,10,1,1,;1:1;
+2024-01-01,inst1,alg0,0,10,7,6,;6:2;7:6;
+2024-01-01,inst1,alg0,1,10,7,2,;7:2;
+2024-01-01,inst1,alg1,0,10,6,1,;6:1;
+2024-01-01,inst1,alg1,1,10,8,7,;3:1;8:7;
+2024-01-01,inst1,alg2,0,10,7,5,;7:5;
+2024-01-01,inst1,alg2,1,10,7,5,;7:5;
+END
+echo "mix.csv all_instances all_algorithms mix_table.csv" > mix.txt
+{
+  "$BIN/tablegenerator" -p mix.txt -S 0.5,1 -o sweep.csv > /dev/null 2>&1
+  cat sweep.csv
+  for s in 0.5 1; do
+    "$BIN/tablegenerator" -p mix.txt -s $s > /dev/null 2>&1
+    tail -n +2 mix_table.csv | sed "s/^/$s,/" > single.csv
+    grep "^$s," sweep.csv | cmp -s - single.csv || echo "scaling $s differs"
+  done
+} > sweep.txt
+expect tablegenerator.sweep sweep.txt <<'END'
+Scaling,Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR
+0.5,Algorithm 0,50.0,0.0,50.0,50.0,27.14,18.57,10.00,1.5
+0.5,Algorithm 1,50.0,0.0,50.0,50.0,58.57,32.86,7.14,2.0
+0.5,Algorithm 2,50.0,50.0,50.0,0.0,50.00,45.00,40.00,2.0
+1,Algorithm 1,100.0,50.0,100.0,100.0,12.50,6.25,0.00,1.5
+1,Algorithm 0,50.0,0.0,50.0,0.0,16.25,11.25,6.25,1.5
+1,Algorithm 2,50.0,0.0,0.0,0.0,56.25,51.25,46.25,2.2
+END
+
+# tablegenerator: the run of alg2 on inst0 with seed 1 is missing from
+# mix.csv; it is reported, and it counts as a run of value and time 0.
+{
+  "$BIN/tablegenerator" -p mix.txt -a 2> /dev/null | grep -A1 WARNING
+  cp mix_table.csv missing_table.csv
+  sed 's/mix/zero/g' mix.txt > zero.txt
+  { cat mix.csv; echo "2024-01-01,inst0,alg2,1,10,0,0,;0:0;"; } > zero.csv
+  "$BIN/tablegenerator" -p zero.txt -a > /dev/null 2>&1
+  cmp -s missing_table.csv zero_table.csv || echo "zero_table.csv differs"
+  cat missing_table.csv
+} > missing.txt
+expect tablegenerator.missing_run missing.txt <<'END'
+WARNING: 1 runs (seed, instance, algorithm) do not appear
+         in file mix.csv; their value and time are taken as 0
+Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR
+Algorithm 1,2,1,2,2,12.50,6.25,0.00,1.5
+Algorithm 0,1,0,1,0,16.25,11.25,6.25,1.5
+Algorithm 2,1,0,0,0,56.25,51.25,46.25,2.2
+END
+
+# tablegenerator: -k ranks the algorithms of every instance and seed, the
+# tied ones sharing the best of their ranks, and AR is their mean.
+"$BIN/tablegenerator" -p mix.txt -s 0.5 -k ranks.csv > /dev/null 2>&1
+cut -d, -f1,9 mix_table.csv >> ranks.csv
+expect tablegenerator.ranks ranks.csv <<'END'
+Instance,Seed,alg0,alg1,alg2
+inst0,0,2,1,3
+inst0,1,1,2,3
+inst1,0,2,2,1
+inst1,1,1,3,1
+Heuristic,AR
+Algorithm 0,1.5
+Algorithm 1,2.0
+Algorithm 2,2.0
+END
+
+# tablegenerator: a results file of several chunks, parsed by as many
+# threads (see ResultsArchive::parse), gives the same table on one thread
+# and on four.
+alg_names 4
+awk 'BEGIN {
+  print "timestamp,graphname,algorithm,seed,timelimit,objective,time,history"
+  for (i = 0; i < 3000; i++)
+    for (s = 0; s < 5; s++)
+      for (a = 0; a < 4; a++) {
+        v = int((i * 7 + s * 31 + a * 13) % 23 / 3)
+        printf "2024-01-01,inst%d,alg%d,%d,10,%d,%d,;%d:%d;%d:%d;\n", \
+          i, a, s, v, a + 5, v - a, a + 1, v, a + 5
+      }
+}' > thr.csv
+echo "thr.csv all_instances all_algorithms thr_table.csv" > thr.txt
+{
+  "$BIN/tablegenerator" -p thr.txt -t 1 -s 0.5 2> /dev/null | grep Read
+  mv thr_table.csv thr1_table.csv
+  "$BIN/tablegenerator" -p thr.txt -t 4 -s 0.5 2> /dev/null | grep Read
+  cmp -s thr1_table.csv thr_table.csv || echo "thr_table.csv differs"
+} > read_threads.txt
+expect tablegenerator.parse_threads read_threads.txt <<'END'
+Read 60000 records. 
+Read 60000 records. 
+END
+
+# tablegenerator: the bootstrap confidence intervals of -B are the same on
+# one thread and on four, and they contain the statistics.
+{
+  "$BIN/tablegenerator" -p thr.txt -s 0.5 -B 200 -t 1 > /dev/null 2>&1
+  mv thr_table.csv thr1_table.csv
+  "$BIN/tablegenerator" -p thr.txt -s 0.5 -B 200 -t 4 > /dev/null 2>&1
+  cmp -s thr1_table.csv thr_table.csv || echo "thr_table.csv differs"
+  "$BIN/tablegenerator" -p mix.txt -B 100 > /dev/null 2>&1
+  head -1 mix_table.csv
+  awk -F, 'NR > 1 {
+    for (m = 2; m <= 9; m++)
+      if ($(2 * m + 6) > $m || $m > $(2 * m + 7)) print "outside", $1, m
+  }' mix_table.csv
+} > bootstrap.txt
+expect tablegenerator.bootstrap bootstrap.txt <<'END'
+Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR,FE_low,FE_high,FS_low,FS_high,BA_low,BA_high,EBA_low,EBA_high,WD_low,WD_high,MD_low,MD_high,BD_low,BD_high,AR_low,AR_high
+END
+
+# tablegenerator: -w counts the instances where every algorithm beats, ties
+# and loses to every other one, by the sum of its values over the seeds and
+# by its best value.
+"$BIN/tablegenerator" -p mix.txt -w wins.csv > /dev/null 2>&1
+expect tablegenerator.wins wins.csv <<'END'
+Algorithm,Opponent,Wins_sum,Ties_sum,Losses_sum,Wins_max,Ties_max,Losses_max
+alg0,alg1,0,1,1,0,1,1
+alg0,alg2,1,1,0,1,1,0
+alg1,alg0,1,1,0,1,1,0
+alg1,alg2,1,1,0,2,0,0
+alg2,alg0,0,1,1,0,1,1
+alg2,alg1,0,1,1,0,0,2
+END
+
+# tablegenerator: -i -f analyzes the instances of the summary file that
+# satisfy the predicate, as the instance file of the parameter file would.
+cat > mix_summary.csv <<'END'
+name,n,m,density,max_deg,mean_deg,sd_deg,n_neg,n_zero,n_pos,max_precision,mean_w,sd_w,interesting,toroidal
+inst0,10,45,1.0,9,9,0,100.0,0.0,0.0,10,1.0,0.0,1,0
+inst1,200,100,0.05,14,10,2,50.0,25.0,25.0,20,0.5,0.2,0,1
+END
+echo inst1 > inst1.txt
+echo "mix.csv some_instances inst1.txt all_algorithms mix_table.csv" \
+  > inst1_param.txt
+{
+  "$BIN/tablegenerator" -p inst1_param.txt > /dev/null 2>&1
+  mv mix_table.csv inst1_table.csv
+  "$BIN/tablegenerator" -p mix.txt -i mix_summary.csv \
+    -f 'n > 100 && toroidal == 1' 2> /dev/null | grep skipped
+  cmp -s inst1_table.csv mix_table.csv || echo "mix_table.csv differs"
+  cat mix_table.csv
+} > subset.txt
+expect tablegenerator.summary_predicate subset.txt <<'END'
+5 where skipped because uninteresting instances
+0 where skipped because uninteresting algorithms
+Heuristic,FE,FS,BA,EBA,WD,MD,BD,AR
+Algorithm 0,100.0,0.0,0.0,0.0,12.50,12.50,12.50,1.5
+Algorithm 1,100.0,0.0,100.0,100.0,25.00,12.50,0.00,2.0
+Algorithm 2,100.0,0.0,0.0,0.0,12.50,12.50,12.50,1.5
+END
+
+# tablegenerator: the statistics, ranks, wins and difficult instances are
+# the same on one thread and on four.
+{
+  for t in 1 4; do
+    "$BIN/tablegenerator" -p thr.txt -t $t -k ranks$t.csv -w wins$t.csv \
+      > /dev/null 2>&1
+    mv thr_table.csv thr$t.csv
+    "$BIN/tablegenerator" -p thr.txt -t $t -d difficult$t.txt -l 1 \
+      > /dev/null 2>&1
+  done
+  for f in thr ranks wins; do
+    cmp -s ${f}1.csv ${f}4.csv || echo "$f differs"
+  done
+  cmp -s difficult1.txt difficult4.txt || echo "difficult differs"
+  wc -l < ranks1.csv
+} > stats.txt
+expect tablegenerator.statistics_threads stats.txt <<'END'
+15001
+END
+
+# tablegenerator: WD, MD and BD average over the instances the worst, mean
+# and best deviation of the values of the seeds from the best value of the
+# instance; on inst0, alg2 deviates by 80% and by 100% (the missing run).
+{
+  "$BIN/tablegenerator" -p mix.txt > /dev/null 2>&1
+  cut -d, -f1,6-8 mix_table.csv
+  "$BIN/tablegenerator" -p mix.txt -s 0.5 > /dev/null 2>&1
+  cut -d, -f1,6-8 mix_table.csv
+} > deviations.txt
+expect tablegenerator.deviations deviations.txt <<'END'
+Heuristic,WD,MD,BD
+Algorithm 1,12.50,6.25,0.00
+Algorithm 0,16.25,11.25,6.25
+Algorithm 2,56.25,51.25,46.25
+Heuristic,WD,MD,BD
+Algorithm 0,27.14,18.57,10.00
+Algorithm 1,58.57,32.86,7.14
+Algorithm 2,50.00,45.00,40.00
+END
+
+# tablegenerator: thousands of names, some of them long, are told apart
+# and numbered in order of first appearance.
+alg_names 2
+awk 'BEGIN {
+  print "timestamp,graphname,algorithm,seed,timelimit,objective,time,history"
+  long = sprintf("%0300d", 0)
+  for (i = 0; i < 5000; i++)
+    for (a = 1; a >= 0; a--) {
+      name = (i % 3 == 0 ? long : "") "g" (i * 7919 % 5000)
+      printf "2024-01-01,%s,alg%d,%d,10,%d,1,;%d:1;\n", name, a, i % 7, a, a
+    }
+}' > names.csv
+echo "names.csv all_instances all_algorithms names_table.csv" > names.txt
+"$BIN/tablegenerator" -p names.txt -V names_best.csv > /dev/null 2>&1
+{
+  tail -n +2 names.csv | awk -F, 'NR % 2 == 1 { print $2 ",1,1,alg1," $4 ",1" }' \
+    | cmp -s - <(tail -n +2 names_best.csv) || echo "names_best.csv differs"
+  wc -l < names_best.csv
+} > interned.txt
+expect tablegenerator.interned_names interned.txt <<'END'
+5001
+END
+
+#-------------------------------------------------------------------
+# extract: a predicate nested too deeply is rejected, not evaluated.
+cat > summary.csv <<'END'
+name,n,m,density,max_deg,mean_deg,sd_deg,n_neg,n_zero,n_pos,max_precision,mean_w,sd_w,interesting,toroidal
+i1,10,45,1.0,9,9,0,100.0,0.0,0.0,10,1.0,0.0,1,0
+i2,200,100,0.05,14,10,2,50.0,25.0,25.0,20,0.5,0.2,0,1
+END
+{
+  echo "deep1.txt $(printf '(%.0s' $(seq 100000))n > 0"
+  echo "deep2.txt n$(printf ' + n%.0s' $(seq 100000)) > 0"
+} > deep.txt
+"$BIN/extract" -s summary.csv -q deep.txt 2>&1 > /dev/null |
+  grep -o 'nested too deeply at position [0-9]*' > nested.txt
+echo "exit status ${PIPESTATUS[0]}" >> nested.txt
+expect extract.nested_predicate nested.txt <<'END'
+nested too deeply at position 258
+exit status 1
+END
+
+# extract: the precedence of the operators of a predicate, the queries of
+# -q, the same answers from the index of -b and an incomplete predicate.
+cat >> summary.csv <<'END'
+i3,1000,3000,0.006,20,6,1,0.0,0.0,100.0,5,-0.5,0.1,1,1
+i4,50,1225,1.0,49,49,0,10.0,0.0,90.0,3,2,0.5,0,0
+END
+cat > queries.txt <<'END'
+# n_neg is a percentage
+q1.txt n_neg>=50
+q2.txt max_precision*2>n_neg&&toroidal!=1
+END
+{
+  "$BIN/extract" -s summary.csv -o s1.txt \
+    -p 'n >= 50 && n <= 1000 && (density < 0.1 || toroidal == 0)' 2> /dev/null
+  "$BIN/extract" -s summary.csv -o s2.txt \
+    -p '!(interesting == 1) && -mean_w * 2 < -1.5 || m / n == 3' 2> /dev/null
+  "$BIN/extract" -s summary.csv -q queries.txt 2> /dev/null
+  cat s1.txt s2.txt q1.txt q2.txt
+  rm -f q1.txt q2.txt
+  "$BIN/extract" -s summary.csv -b 2> /dev/null
+  "$BIN/extract" -s summary.csv -q queries.txt 2> /dev/null
+  cat q1.txt q2.txt
+  "$BIN/extract" -s summary.csv -o s3.txt -p 'n > ' 2>&1
+  echo "exit status $?"
+} | grep -v '^$\|Extracted' > select.txt
+expect extract.predicates select.txt <<'END'
+i2
+i3
+i4
+i3
+i4
+i1
+i2
+Compiled 4 instances of summary.csv into summary.csv.idx
+i1
+i2
+Error: Invalid predicate "n > ": unexpected end at position 5
+exit status 1
+END
+
+#-------------------------------------------------------------------
+# qplib2mc: a file that cannot be converted does not stop the others, and
+# an existing output named after it is not removed when the conversion
+# fails before writing it; two instances of the same name are rejected
+# before any conversion.
+printf 'qp_a\nl\nl\n3\n1\n1 2 2\n0\n0\n' > a.qp
+printf 'qp_b\nl\nl\n3\n1\n1 9 2\n0\n0\n' > b.qp
+printf 'qp_c\nl\nl\n3\n1\n1 3 2\n0\n1\n2 1\n' > c.qp
+cp a.qp a2.qp
+echo "kept" > qp_b.txt
+{
+  "$BIN/qplib2mc" -t 2 a.qp b.qp c.qp 2>&1
+  echo "exit status $?"
+  ls qp_*.txt
+  rm -f qp_*.txt
+  "$BIN/qplib2mc" c.qp a.qp a2.qp 2>&1
+  echo "exit status $?"
+  ls qp_*.txt 2> /dev/null
+} > qplib.txt
+expect qplib2mc.failed_file qplib.txt <<'END'
+Error: b.qp: node out of range in edge 1 9
+exit status 1
+qp_a.txt
+qp_b.txt
+qp_c.txt
+Error: a.qp and a2.qp would both be written to qp_a.txt
+exit status 1
+END
+
+#-------------------------------------------------------------------
+# graphbatch: a malformed input fails its line only; its output is removed,
+# the summary is complete and the exit status is 1.  The output of a line
+# whose input does not exist is not touched.
+printf '3 2\n1 2 1.5\n2 3 -2\n' > g1.txt
+printf '3 2\n1 2 1.5\n2 x 1\n' > g2.txt
+printf '3 1\n1 3 4\n' > g3.txt
+echo "kept" > p4.txt
+printf 'qubo2mc g1.txt p1.txt\nqubo2mc g2.txt p2.txt\ndechimera g3.txt p3.txt\n' \
+  > manifest.txt
+echo "qubo2mc g4.txt p4.txt" >> manifest.txt
+"$BIN/graphbatch" -t 2 manifest.txt 2> /dev/null | sed 1d | cut -d' ' -f1-4,6- \
+  > batch.txt
+echo "exit status ${PIPESTATUS[0]}" >> batch.txt
+ls p*.txt >> batch.txt
+"$BIN/Qubo2mc" < g1.txt | cmp -s - p1.txt || echo "p1.txt differs" >> batch.txt
+expect graphbatch.malformed_input batch.txt <<'END'
+qubo2mc g1.txt 4 5 0 ok
+qubo2mc g2.txt 0 0 0 failed
+dechimera g3.txt 2 1 1 ok
+qubo2mc g4.txt 0 0 0 failed
+exit status 1
+p1.txt
+p3.txt
+p4.txt
+END
+
+# graphbatch: the outputs do not depend on the number of threads, which
+# sort the edges of the last files.
+for t in 1 3; do
+  printf 'qubo2mc -m g1.txt m1_%s.txt\nqubo2mc -B g1.txt m2_%s.txt\n' $t $t
+  printf 'dechimera g3.txt m3_%s.txt\n' $t
+done > jobs.txt
+"$BIN/graphbatch" -t 1 <(grep _1 jobs.txt) > /dev/null 2>&1
+"$BIN/graphbatch" -t 3 <(grep _3 jobs.txt) > /dev/null 2>&1
+for k in 1 2 3; do
+  cmp -s "m${k}_1.txt" "m${k}_3.txt" || echo "m$k differs"
+done > threads.txt
+cat m1_1.txt m3_1.txt >> threads.txt
+expect graphbatch.threads threads.txt <<'END'
+4 5
+1 2 -1.5
+1 3 0.5
+1 4 2
+2 3 1.5
+3 4 -2
+2 1
+1 2 4
+END
+
+# negate, scale_img: a truncated or malformed input is reported, with exit
+# status 1, instead of aborting.
+for prog in negate scale_img; do
+  printf '3 2\n1 2 1\n' | "$BIN/$prog" > /dev/null 2> err.txt
+  echo "$prog truncated $? $(cat err.txt)"
+  printf '3 1\n1 2 x\n' | "$BIN/$prog" > /dev/null 2> err.txt
+  echo "$prog malformed $? $(cat err.txt)"
+done > errors.txt
+expect converters.invalid_input errors.txt <<'END'
+negate truncated 1 Error: unexpected end of input
+negate malformed 1 Error: invalid number x
+scale_img truncated 1 Error: unexpected end of input
+scale_img malformed 1 Error: invalid number x
+END
+
+#-------------------------------------------------------------------
+# graphbin: a graph converted to the binary format and back is unchanged,
+# with -c the edges are sorted by their first node; a node above 2^32 - 1
+# is rejected instead of wrapped.
+printf '4 5\n1 2 0.5\n2 3 -0.25\n1 3 2\n3 4 0\n2 2 1.125\n' > g.txt
+printf '3 3\n3 1 2\n1 2 -1.5\n2 3 4\n' > h.txt
+{
+  "$BIN/graphbin" < g.txt | "$BIN/graphbin" -d
+  "$BIN/graphbin" -c < h.txt | "$BIN/graphbin" -d
+  "$BIN/Qubo2mc" -B < g.txt | "$BIN/graphbin" -d |
+    cmp -s - <("$BIN/Qubo2mc" < g.txt) || echo "Qubo2mc -B differs"
+  printf '3 1\n4294967297 2 1.5\n' | "$BIN/graphbin" 2>&1 > /dev/null
+  echo "exit status ${PIPESTATUS[1]}"
+  printf '5000000000 0\n' | "$BIN/graphbin" 2>&1 > /dev/null
+} > graphbin.txt
+expect graphbin.round_trip graphbin.txt <<'END'
+4 5
+1 2 0.5
+2 3 -0.25
+1 3 2
+3 4 0
+2 2 1.125
+3 3
+1 2 -1.5
+2 3 4
+3 1 2
+Error: node out of range of the binary format in edge 4294967297 2
+exit status 1
+Error: 5000000000 nodes do not fit in the binary format
+END
+
+# Qubo2mc: with -m, the entries (i,j) and (j,i) of Q are merged into one
+# edge, dropped when they cancel out.
+printf '3 5\n1 2 1.5\n2 1 -1.5\n1 3 1\n3 1 2\n2 2 4\n' > q.txt
+{
+  "$BIN/Qubo2mc" < q.txt
+  "$BIN/Qubo2mc" -m < q.txt
+} > qubo.txt
+expect Qubo2mc.merge qubo.txt <<'END'
+4 7
+1 2 -3
+1 3 -4
+1 4 -3
+2 3 1.5
+2 4 1
+3 2 -1.5
+4 2 2
+4 4
+1 2 -3
+1 3 -4
+1 4 -3
+2 4 3
+END
+
+# deChimera: with -m, the parallel edges are merged, dropped when they
+# cancel out, and the nodes left isolated are removed.
+printf '4 4\n1 2 1.5\n2 1 -1.5\n3 4 1\n4 3 2\n' > d.txt
+{
+  "$BIN/deChimera" < d.txt
+  "$BIN/deChimera" -m < d.txt
+} > dechimera.txt
+expect deChimera.merge dechimera.txt <<'END'
+4 4
+1 2 1.5
+1 2 -1.5
+3 4 1
+3 4 2
+2 1
+1 2 3
+END
+
+# graphpipe: a chain of transforms, in text or in binary between two
+# graphpipe, writes the graph of the chained programs.
+"$BIN/qplib2mc" a.qp > /dev/null 2>&1
+{
+  "$BIN/graphpipe" qubo2mc dechimera scale < g.txt |
+    cmp -s - <("$BIN/Qubo2mc" < g.txt | "$BIN/deChimera" | "$BIN/scale_img") ||
+    echo "qubo2mc dechimera scale differs"
+  "$BIN/graphpipe" negate scale < g.txt |
+    cmp -s - <("$BIN/negate" < g.txt | "$BIN/scale_img") ||
+    echo "negate scale differs"
+  "$BIN/graphpipe" -B qubo2mc negate < g.txt | "$BIN/graphpipe" -b dechimera |
+    cmp -s - <("$BIN/Qubo2mc" < g.txt | "$BIN/negate" | "$BIN/deChimera") ||
+    echo "binary qubo2mc negate dechimera differs"
+  "$BIN/graphpipe" qplib2mc dechimera < a.qp |
+    cmp -s - <("$BIN/deChimera" < qp_a.txt) || echo "qplib2mc dechimera differs"
+  "$BIN/graphpipe" negate scale < g.txt
+} > pipe.txt
+expect graphpipe.chained_tools pipe.txt <<'END'
+4 5
+1 2 -50000000
+2 3 25000000
+1 3 -200000000
+3 4 0
+2 2 -112500000
+END
+
+exit $failed